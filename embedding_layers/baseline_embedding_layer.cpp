@@ -8,6 +8,7 @@
 #include <string>
 #include <numeric> // For std::accumulate
 #include <cmath> // For std::sqrt
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
 
 // Global constants
 const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
@@ -17,22 +18,7 @@ const size_t NUM_COLS = 25;        // GloVe embedding dimension
 // Function to perform row operations without prefetching
 double regularAccess(const std::vector<std::vector<double>>& matrix, 
                     const std::vector<size_t>& accessPattern) {
-    double result = 0.0;
-    
-    for (size_t i = 0; i < accessPattern.size(); i++) {
-        const auto& row = matrix[accessPattern[i]];
-        // Compute dot product NUM_COLS times
-        double row_sum = 0.0;
-        for (size_t n = 0; n < 2; n++) {
-            double dot_product = 0.0;
-            for (size_t j = 0; j < NUM_COLS; j++) {
-                dot_product += row[j] * row[j];
-            }
-            row_sum += dot_product;
-        }
-        result += row_sum / NUM_COLS;
-    }
-    return result / accessPattern.size();
+    return pipelineAccess<double, NUM_COLS, DoubleDotReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
 }
 
 int main() {
@@ -0,0 +1,126 @@
+#ifndef CORO_FETCH_HPP
+#define CORO_FETCH_HPP
+
+#include <coroutine>
+#include <vector>
+#include <utility>
+
+// Requires C++20 (-std=c++20)
+
+// Round-robin scheduler for lookup coroutines. A coroutine suspended on a
+// row fetch is queued behind every other in-flight coroutine, so it is only
+// resumed after all of them have run once more. That interleaved work is
+// what covers the memory latency of its row: with G coroutines in flight a
+// fetch is effectively issued G - 1 lookups ahead.
+class FetchScheduler {
+public:
+    explicit FetchScheduler(size_t capacity = 64) : ready_(roundUpPow2(capacity)), head_(0), tail_(0) {}
+
+    void schedule(std::coroutine_handle<> handle) {
+        if (tail_ - head_ == ready_.size()) {
+            grow();
+        }
+        ready_[tail_++ & (ready_.size() - 1)] = handle;
+    }
+
+    // Resume ready coroutines until all of them have finished
+    void run() {
+        while (head_ != tail_) {
+            std::coroutine_handle<> handle = ready_[head_++ & (ready_.size() - 1)];
+            handle.resume();
+        }
+    }
+
+private:
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    void grow() {
+        std::vector<std::coroutine_handle<>> bigger(ready_.size() * 2);
+        for (size_t i = head_; i != tail_; i++) {
+            bigger[i - head_] = ready_[i & (ready_.size() - 1)];
+        }
+        tail_ -= head_;
+        head_ = 0;
+        ready_.swap(bigger);
+    }
+
+    std::vector<std::coroutine_handle<>> ready_; // Ring buffer of ready coroutines
+    size_t head_;
+    size_t tail_;
+};
+
+// Coroutine return type for lookup work. The coroutine starts suspended and
+// is handed to a FetchScheduler with spawn(); its co_return value is read
+// back with result() once the scheduler has run it to completion.
+template <typename T>
+class LookupTask {
+public:
+    struct promise_type {
+        T value{};
+
+        LookupTask get_return_object() {
+            return LookupTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(T v) { value = std::move(v); }
+        void unhandled_exception() { throw; }
+    };
+
+    explicit LookupTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    LookupTask(LookupTask&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    LookupTask(const LookupTask&) = delete;
+    LookupTask& operator=(const LookupTask&) = delete;
+    ~LookupTask() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    void spawn(FetchScheduler& scheduler) { scheduler.schedule(handle_); }
+    bool done() const { return handle_.done(); }
+    const T& result() const { return handle_.promise().value; }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Embedding table view with an awaitable row fetch. co_await table.fetch(idx)
+// prefetches the row with the Prefetch policy of prefetch_pipeline.hpp,
+// suspends the calling coroutine and evaluates to a pointer to the row once
+// it is resumed. Dim is the row width.
+template <size_t Dim, typename Prefetch>
+class CoroEmbeddingTable {
+public:
+    struct RowFetch {
+        FetchScheduler& scheduler;
+        const double* row;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { scheduler.schedule(handle); }
+        const double* await_resume() const noexcept { return row; }
+    };
+
+    CoroEmbeddingTable(const std::vector<std::vector<double>>& matrix, FetchScheduler& scheduler)
+        : matrix_(matrix), scheduler_(scheduler) {}
+
+    RowFetch fetch(size_t idx) {
+        const double* row = matrix_[idx].data();
+        Prefetch::template issue<double, Dim>(row);
+        return RowFetch{scheduler_, row};
+    }
+
+    size_t numCols() const { return Dim; }
+
+private:
+    const std::vector<std::vector<double>>& matrix_;
+    FetchScheduler& scheduler_;
+};
+
+#endif // CORO_FETCH_HPP
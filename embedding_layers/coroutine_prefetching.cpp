@@ -0,0 +1,233 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <x86intrin.h> // For _mm_prefetch
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <numeric> // For std::accumulate
+#include <cmath> // For std::sqrt
+#include <algorithm> // For std::max
+#include "coro_fetch.hpp" // Coroutine row fetch API (C++20)
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 25;        // GloVe embedding dimension
+const size_t PREFETCH_AHEAD = 11;  // Prefetch ahead distance of the hand-rolled loop
+const size_t MAX_COROUTINES = 64;  // Largest number of in-flight coroutines tested
+const size_t BAG_SIZE = 8;         // Rows summed per bag in the bag-of-embeddings example
+const size_t NUM_RUNS = 10;        // Number of times to run each test
+
+// Prefetch policy shared by the hand-rolled loop and the coroutine fetch, so
+// the two differ only in how the lookahead is organised
+typedef FirstLinePrefetch<_MM_HINT_T0> RowPrefetch;
+typedef CoroEmbeddingTable<NUM_COLS, RowPrefetch> CoroTable;
+
+// Function to perform row operations without prefetching
+double regularAccess(const std::vector<std::vector<double>>& matrix,
+                    const std::vector<size_t>& accessPattern) {
+    return pipelineAccess<double, NUM_COLS, DoubleDotReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
+}
+
+// Function to perform row operations with hand-rolled fixed-distance prefetching
+double prefetchedAccess(const std::vector<std::vector<double>>& matrix,
+                       const std::vector<size_t>& accessPattern) {
+    return pipelineAccess<double, NUM_COLS, DoubleDotReduce, RowPrefetch>(
+        matrix, accessPattern, FixedDistancePredictor<PREFETCH_AHEAD>());
+}
+
+// Row operation shared by the coroutine workers. It lives outside the
+// coroutine bodies so its loops keep their locals in registers instead of
+// the coroutine frame.
+inline double rowOp(const double* row) {
+    return DoubleDotReduce::apply<double, NUM_COLS>(row);
+}
+
+// The same row operation written as straight-line coroutine code. Worker
+// `first` handles tokens first, first + stride, ... so that with `stride`
+// workers round-robined by the scheduler the tokens are consumed in their
+// original order, each fetch issued stride - 1 tokens ahead of its use.
+LookupTask<double> rowWorker(CoroTable& table,
+                             const std::vector<size_t>& accessPattern,
+                             size_t first, size_t stride) {
+    double result = 0.0;
+    for (size_t i = first; i < accessPattern.size(); i += stride) {
+        const double* row = co_await table.fetch(accessPattern[i]);
+        result += rowOp(row);
+    }
+    co_return result;
+}
+
+// Function to perform row operations with numCoroutines interleaved workers
+double coroutineAccess(const std::vector<std::vector<double>>& matrix,
+                       const std::vector<size_t>& accessPattern,
+                       size_t numCoroutines) {
+    FetchScheduler scheduler(numCoroutines);
+    CoroTable table(matrix, scheduler);
+
+    std::vector<LookupTask<double>> workers;
+    for (size_t c = 0; c < numCoroutines; c++) {
+        workers.push_back(rowWorker(table, accessPattern, c, numCoroutines));
+        workers.back().spawn(scheduler);
+    }
+    scheduler.run();
+
+    double result = 0.0;
+    for (const auto& worker : workers) {
+        result += worker.result();
+    }
+    return result / accessPattern.size();
+}
+
+// Bag-of-embeddings sum written naturally against the coroutine API: each
+// worker pools every stride-th bag of BAG_SIZE consecutive tokens.
+LookupTask<double> bagSumWorker(CoroTable& table,
+                                const std::vector<size_t>& accessPattern,
+                                std::vector<double>& pooled,
+                                size_t first, size_t stride) {
+    size_t numBags = accessPattern.size() / BAG_SIZE;
+    for (size_t bag = first; bag < numBags; bag += stride) {
+        double* out = &pooled[bag * NUM_COLS];
+        for (size_t k = 0; k < BAG_SIZE; k++) {
+            const double* row = co_await table.fetch(accessPattern[bag * BAG_SIZE + k]);
+            for (size_t j = 0; j < NUM_COLS; j++) {
+                out[j] += row[j];
+            }
+        }
+    }
+    co_return 0.0;
+}
+
+std::vector<double> coroutineBagSum(const std::vector<std::vector<double>>& matrix,
+                                    const std::vector<size_t>& accessPattern,
+                                    size_t numCoroutines) {
+    FetchScheduler scheduler(numCoroutines);
+    CoroTable table(matrix, scheduler);
+    std::vector<double> pooled(accessPattern.size() / BAG_SIZE * NUM_COLS, 0.0);
+
+    std::vector<LookupTask<double>> workers;
+    for (size_t c = 0; c < numCoroutines; c++) {
+        workers.push_back(bagSumWorker(table, accessPattern, pooled, c, numCoroutines));
+        workers.back().spawn(scheduler);
+    }
+    scheduler.run();
+    return pooled;
+}
+
+std::vector<double> regularBagSum(const std::vector<std::vector<double>>& matrix,
+                                  const std::vector<size_t>& accessPattern) {
+    size_t numBags = accessPattern.size() / BAG_SIZE;
+    std::vector<double> pooled(numBags * NUM_COLS, 0.0);
+    for (size_t bag = 0; bag < numBags; bag++) {
+        for (size_t k = 0; k < BAG_SIZE; k++) {
+            const auto& row = matrix[accessPattern[bag * BAG_SIZE + k]];
+            for (size_t j = 0; j < NUM_COLS; j++) {
+                pooled[bag * NUM_COLS + j] += row[j];
+            }
+        }
+    }
+    return pooled;
+}
+
+// Time NUM_RUNS calls of fn and return the mean and standard deviation in ms
+template <typename Fn>
+std::pair<double, double> timeRuns(Fn fn) {
+    std::vector<double> times;
+    for (size_t run = 0; run < NUM_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6);
+    }
+    double mean = std::accumulate(times.begin(), times.end(), 0.0) / NUM_RUNS;
+    double var = 0.0;
+    for (double t : times) {
+        var += std::pow(t - mean, 2);
+    }
+    return std::make_pair(mean, std::sqrt(var / NUM_RUNS));
+}
+
+int main() {
+    // Load GloVe embeddings
+    std::cout << "Loading GloVe embeddings..." << std::endl;
+    std::unordered_map<std::string, size_t> word_to_idx;
+    std::vector<std::vector<double>> matrix;
+
+    std::ifstream glove_file(GLOVE_PATH);
+    std::string line;
+    size_t idx = 0;
+
+    while (std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        std::vector<double> embedding(NUM_COLS);
+        for (size_t i = 0; i < NUM_COLS; i++) {
+            iss >> embedding[i];
+        }
+
+        word_to_idx[word] = idx;
+        matrix.push_back(embedding);
+        idx++;
+    }
+
+    // Load input words and create access pattern
+    std::cout << "Loading input words..." << std::endl;
+    std::vector<size_t> accessPattern;
+    std::ifstream input_file(INPUT_PATH);
+    std::string word;
+
+    while (input_file >> word) {
+        if (word_to_idx.find(word) != word_to_idx.end()) {
+            accessPattern.push_back(word_to_idx[word]);
+        }
+    }
+
+    if (accessPattern.empty()) {
+        std::cerr << "No valid words found in input file!" << std::endl;
+        return 1;
+    }
+
+    double result1 = 0.0, result2 = 0.0, result3 = 0.0;
+
+    auto regular = timeRuns([&] { result1 = regularAccess(matrix, accessPattern); });
+    auto prefetched = timeRuns([&] { result2 = prefetchedAccess(matrix, accessPattern); });
+
+    std::cout << "\nRegular access time: " << regular.first << " ± " << regular.second << " ms" << std::endl;
+    std::cout << "Prefetched access time (PREFETCH_AHEAD = " << PREFETCH_AHEAD << "): "
+              << prefetched.first << " ± " << prefetched.second << " ms"
+              << ", speedup " << regular.first / prefetched.first << "x" << std::endl;
+
+    // Sweep the number of in-flight coroutines
+    for (size_t numCoroutines = 2; numCoroutines <= MAX_COROUTINES; numCoroutines *= 2) {
+        auto coro = timeRuns([&] { result3 = coroutineAccess(matrix, accessPattern, numCoroutines); });
+        std::cout << "Coroutine access time (" << numCoroutines << " coroutines): "
+                  << coro.first << " ± " << coro.second << " ms"
+                  << ", speedup " << regular.first / coro.first << "x"
+                  << ", vs prefetched " << prefetched.first / coro.first << "x"
+                  << ", results match " << (std::abs(result1 - result3) < 1e-10) << std::endl;
+    }
+    std::cout << "Prefetched results match: " << (std::abs(result1 - result2) < 1e-10) << std::endl;
+
+    // Bag-of-embeddings sum through the coroutine API
+    std::vector<double> pooled1, pooled2;
+    auto bag_regular = timeRuns([&] { pooled1 = regularBagSum(matrix, accessPattern); });
+    auto bag_coro = timeRuns([&] { pooled2 = coroutineBagSum(matrix, accessPattern, PREFETCH_AHEAD + 1); });
+
+    double max_diff = 0.0;
+    for (size_t i = 0; i < pooled1.size(); i++) {
+        max_diff = std::max(max_diff, std::abs(pooled1[i] - pooled2[i]));
+    }
+    std::cout << "\nRegular bag sum time: " << bag_regular.first << " ± " << bag_regular.second << " ms" << std::endl;
+    std::cout << "Coroutine bag sum time (" << PREFETCH_AHEAD + 1 << " coroutines): "
+              << bag_coro.first << " ± " << bag_coro.second << " ms"
+              << ", speedup " << bag_regular.first / bag_coro.first << "x" << std::endl;
+    std::cout << "Bag sums match: " << (max_diff < 1e-10) << std::endl;
+
+    return 0;
+}
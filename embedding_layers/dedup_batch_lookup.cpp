@@ -0,0 +1,169 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <numeric> // For std::accumulate
+#include <cmath> // For std::sqrt
+#include "dedup_lookup.hpp" // Deduplicated batch lookup
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 25;        // GloVe embedding dimension
+const size_t PREFETCH_AHEAD = 11;  // Prefetch ahead distance within a batch
+const size_t MIN_BATCH = 8;        // Smallest batch size tested
+const size_t MAX_BATCH = 32768;    // Largest batch size tested
+const size_t NUM_RUNS = 10;        // Number of times to run each test
+
+typedef FirstLinePrefetch<_MM_HINT_T0> RowPrefetch;
+
+const char* strategyName(DedupStrategy strategy) {
+    switch (strategy) {
+        case DEDUP_NONE: return "none";
+        case DEDUP_SORT: return "sort";
+        case DEDUP_HASH: return "hash";
+        case DEDUP_AUTO: return "auto";
+    }
+    return "unknown";
+}
+
+// Average of squared values in a row
+inline double rowOp(const std::vector<double>& row) {
+    return MeanSquareReduce::apply<double, NUM_COLS>(&row[0]);
+}
+
+// Function to perform row operations without prefetching
+double regularAccess(const std::vector<std::vector<double>>& matrix,
+                    const std::vector<size_t>& accessPattern) {
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
+}
+
+// Function to perform row operations batch by batch, deduplicating each
+// batch with the given strategy. Per-token results are reduced in their
+// original order so the result matches regularAccess.
+double batchedAccess(const std::vector<std::vector<double>>& matrix,
+                     const std::vector<size_t>& accessPattern,
+                     size_t batchSize, DedupStrategy strategy,
+                     std::vector<double>& tokenResults) {
+    BatchDeduplicator dedup;
+    std::vector<double> uniqueResults;
+    tokenResults.resize(accessPattern.size());
+
+    for (size_t begin = 0; begin < accessPattern.size(); begin += batchSize) {
+        size_t n = std::min(batchSize, accessPattern.size() - begin);
+        dedupLookup<NUM_COLS, RowPrefetch>(matrix, &accessPattern[begin], n, strategy, dedup, PREFETCH_AHEAD,
+                                           rowOp, uniqueResults, &tokenResults[begin]);
+    }
+
+    double result = 0.0;
+    for (size_t i = 0; i < tokenResults.size(); i++) {
+        result += tokenResults[i];
+    }
+    return result / accessPattern.size();
+}
+
+int main() {
+    // Load GloVe embeddings
+    std::cout << "Loading GloVe embeddings..." << std::endl;
+    std::unordered_map<std::string, size_t> word_to_idx;
+    std::vector<std::vector<double>> matrix;
+
+    std::ifstream glove_file(GLOVE_PATH);
+    std::string line;
+    size_t idx = 0;
+
+    while (std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        std::vector<double> embedding(NUM_COLS);
+        for (size_t i = 0; i < NUM_COLS; i++) {
+            iss >> embedding[i];
+        }
+
+        word_to_idx[word] = idx;
+        matrix.push_back(embedding);
+        idx++;
+    }
+
+    // Load input words and create access pattern
+    std::cout << "Loading input words..." << std::endl;
+    std::vector<size_t> accessPattern;
+    std::ifstream input_file(INPUT_PATH);
+    std::string word;
+
+    while (input_file >> word) {
+        if (word_to_idx.find(word) != word_to_idx.end()) {
+            accessPattern.push_back(word_to_idx[word]);
+        }
+    }
+
+    if (accessPattern.empty()) {
+        std::cerr << "No valid words found in input file!" << std::endl;
+        return 1;
+    }
+
+    // Sequential baseline
+    std::vector<double> regular_times;
+    double result1 = 0.0;
+    for (size_t run = 0; run < NUM_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        result1 = regularAccess(matrix, accessPattern);
+        auto end = std::chrono::steady_clock::now();
+        regular_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6);
+    }
+    double reg_mean = std::accumulate(regular_times.begin(), regular_times.end(), 0.0) / NUM_RUNS;
+    std::cout << "\nRegular access time: " << reg_mean << " ms" << std::endl;
+
+    const DedupStrategy strategies[] = {DEDUP_NONE, DEDUP_SORT, DEDUP_HASH, DEDUP_AUTO};
+    const size_t row_bytes = NUM_COLS * sizeof(double);
+    std::vector<double> tokenResults;
+
+    for (size_t batchSize = MIN_BATCH; batchSize <= MAX_BATCH; batchSize *= 4) {
+        // Dedup ratio and bandwidth saved for this batch size
+        BatchDeduplicator dedup;
+        size_t numBatches = 0, totalUnique = 0;
+        for (size_t begin = 0; begin < accessPattern.size(); begin += batchSize) {
+            size_t n = std::min(batchSize, accessPattern.size() - begin);
+            dedup.dedup(&accessPattern[begin], n, DEDUP_HASH);
+            totalUnique += dedup.unique().size();
+            numBatches++;
+        }
+        double dedup_ratio = static_cast<double>(accessPattern.size()) / totalUnique;
+        double saved_per_batch = static_cast<double>(accessPattern.size() - totalUnique) * row_bytes / numBatches;
+
+        std::cout << "\nBatch size " << batchSize << " (auto picks " << strategyName(BatchDeduplicator::choose(batchSize, row_bytes, dedup_ratio)) << ")"
+                  << ": dedup ratio " << dedup_ratio << "x"
+                  << ", row bytes saved per batch " << saved_per_batch / 1024.0 << " KiB" << std::endl;
+
+        for (DedupStrategy strategy : strategies) {
+            std::vector<double> batch_times;
+            double result2 = 0.0;
+            for (size_t run = 0; run < NUM_RUNS; run++) {
+                auto start = std::chrono::steady_clock::now();
+                result2 = batchedAccess(matrix, accessPattern, batchSize, strategy, tokenResults);
+                auto end = std::chrono::steady_clock::now();
+                batch_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6);
+            }
+
+            double mean = std::accumulate(batch_times.begin(), batch_times.end(), 0.0) / NUM_RUNS;
+            double var = 0.0;
+            for (size_t i = 0; i < NUM_RUNS; i++) {
+                var += std::pow(batch_times[i] - mean, 2);
+            }
+            var /= NUM_RUNS;
+
+            std::cout << "  " << strategyName(strategy) << ": " << mean << " ± " << std::sqrt(var) << " ms"
+                      << ", speedup " << reg_mean / mean << "x"
+                      << ", results match " << (std::abs(result1 - result2) < 1e-10) << std::endl;
+        }
+    }
+
+    return 0;
+}
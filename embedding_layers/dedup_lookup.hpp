@@ -0,0 +1,207 @@
+#ifndef DEDUP_LOOKUP_HPP
+#define DEDUP_LOOKUP_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include "prefetch_pipeline.hpp" // Prefetch policies
+
+// How a batch of indices is deduplicated before its rows are fetched
+enum DedupStrategy {
+    DEDUP_NONE, // Fetch every occurrence
+    DEDUP_SORT, // Sort packed (index, position) keys
+    DEDUP_HASH, // Open-addressing hash table with linear probing
+    DEDUP_AUTO  // Pick one of the above from the batch size
+};
+
+// DEDUP_AUTO deduplicates, with the hash table (which beat sorting at every
+// batch size in dedup_batch_lookup), only when the row bytes it expects to
+// save per token, rowBytes * (1 - 1 / dedup ratio), reach
+// DEDUP_MIN_SAVED_BYTES. Hashing costs a few ns per token, so the savings have
+// to outweigh it: with cache-resident tables on a Xeon (2 MiB L2, 105 MiB L3)
+// hash broke even at about 500-650 saved bytes per token and lost at every
+// batch size with 25 d double rows (200 bytes, hash 0.5-0.6x of no dedup).
+// Tables far larger than the LLC break even earlier (150-400 bytes), so the
+// threshold errs towards not deduplicating. DEDUP_SORT stays available for
+// callers that want the unique rows in ascending address order.
+const size_t DEDUP_MIN_BATCH = 512;        // Smaller batches repeat too few rows
+const size_t DEDUP_MIN_SAVED_BYTES = 512;  // Row bytes saved per token for DEDUP_AUTO to dedup
+const size_t DEDUP_PROBE_INTERVAL = 64;    // DEDUP_AUTO re-measures the ratio every this many batches
+// Positions and unique ids are 32-bit (inverse map, packed sort keys)
+const uint64_t DEDUP_MAX_BATCH = 0xffffffffULL;
+const uint64_t DEDUP_EMPTY_SLOT = ~0ULL;
+
+// Deduplicates batches of row indices into a list of unique rows plus an
+// inverse map from every batch position to its unique row. Buffers are kept
+// between batches so steady-state batches do not allocate.
+class BatchDeduplicator {
+public:
+    BatchDeduplicator() : ratio_(0.0), sinceProbe_(0) {}
+
+    // Strategy for a batch of n tokens of rowBytes-byte rows that repeat
+    // each row ratio times on average
+    static DedupStrategy choose(size_t n, size_t rowBytes, double ratio) {
+        if (n < DEDUP_MIN_BATCH || n > DEDUP_MAX_BATCH || ratio <= 1.0) {
+            return DEDUP_NONE;
+        }
+        return rowBytes * (1.0 - 1.0 / ratio) >= DEDUP_MIN_SAVED_BYTES ? DEDUP_HASH : DEDUP_NONE;
+    }
+
+    // DEDUP_AUTO choice from the dedup ratio observed on earlier batches.
+    // Rows smaller than DEDUP_MIN_SAVED_BYTES can never save enough, so they
+    // are never deduplicated; otherwise a batch is deduplicated to measure
+    // the ratio first and again every DEDUP_PROBE_INTERVAL batches.
+    DedupStrategy chooseAuto(size_t n, size_t rowBytes) {
+        if (n < DEDUP_MIN_BATCH || n > DEDUP_MAX_BATCH || rowBytes < DEDUP_MIN_SAVED_BYTES) {
+            return DEDUP_NONE;
+        }
+        if (ratio_ == 0.0 || ++sinceProbe_ >= DEDUP_PROBE_INTERVAL) {
+            sinceProbe_ = 0;
+            return DEDUP_HASH;
+        }
+        return choose(n, rowBytes, ratio_);
+    }
+
+    // Deduplicate tokens[0..n), n <= DEDUP_MAX_BATCH. Returns the strategy
+    // actually used: DEDUP_SORT falls back to DEDUP_HASH for indices that do
+    // not fit its 32-bit key half. Without a row size DEDUP_AUTO means
+    // DEDUP_HASH here; dedupLookup resolves it with chooseAuto() instead.
+    DedupStrategy dedup(const size_t* tokens, size_t n, DedupStrategy strategy) {
+        if (n > DEDUP_MAX_BATCH) {
+            throw std::length_error("BatchDeduplicator::dedup: batch larger than DEDUP_MAX_BATCH");
+        }
+        unique_.clear();
+        inverse_.resize(n);
+
+        if (strategy == DEDUP_AUTO || (strategy == DEDUP_SORT && !dedupSort(tokens, n))) {
+            strategy = DEDUP_HASH;
+        }
+        if (strategy == DEDUP_HASH) {
+            dedupHash(tokens, n);
+        } else if (strategy == DEDUP_NONE) {
+            for (size_t i = 0; i < n; i++) {
+                unique_.push_back(tokens[i]);
+                inverse_[i] = static_cast<uint32_t>(i);
+            }
+        }
+        if (strategy != DEDUP_NONE && !unique_.empty()) {
+            ratio_ = static_cast<double>(n) / unique_.size();
+        }
+        return strategy;
+    }
+
+    const std::vector<size_t>& unique() const { return unique_; }
+    const std::vector<uint32_t>& inverse() const { return inverse_; }
+
+    // Tokens per unique row of the last deduplicated batch (0 before the first)
+    double observedRatio() const { return ratio_; }
+
+private:
+    // Pack each (index, position) pair into one 64-bit key so a single sort
+    // over plain integers groups the occurrences of every row. Unique rows
+    // come out in ascending index order. Returns false, without touching
+    // unique_, if an index does not fit in the upper 32 bits of a key.
+    bool dedupSort(const size_t* tokens, size_t n) {
+        keys_.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            if (tokens[i] > 0xffffffffULL) {
+                return false;
+            }
+            keys_[i] = (static_cast<uint64_t>(tokens[i]) << 32) | i;
+        }
+        std::sort(keys_.begin(), keys_.end());
+
+        uint64_t prev = ~0ULL;
+        for (size_t k = 0; k < n; k++) {
+            uint64_t idx = keys_[k] >> 32;
+            if (idx != prev) {
+                unique_.push_back(idx);
+                prev = idx;
+            }
+            inverse_[keys_[k] & 0xffffffffULL] = static_cast<uint32_t>(unique_.size() - 1);
+        }
+        return true;
+    }
+
+    // Linear probing over flat arrays sized to at least twice the batch.
+    // Unique rows come out in first-occurrence order.
+    void dedupHash(const size_t* tokens, size_t n) {
+        size_t capacity = 1;
+        int shift = 64;
+        while (capacity < 2 * n) {
+            capacity <<= 1;
+            shift--;
+        }
+        slotKeys_.assign(capacity, DEDUP_EMPTY_SLOT);
+        slotUnique_.resize(capacity);
+
+        for (size_t i = 0; i < n; i++) {
+            uint64_t idx = tokens[i];
+            size_t slot = shift < 64 ? static_cast<size_t>((idx * 0x9E3779B97F4A7C15ULL) >> shift) : 0;
+            while (slotKeys_[slot] != DEDUP_EMPTY_SLOT && slotKeys_[slot] != idx) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            if (slotKeys_[slot] == DEDUP_EMPTY_SLOT) {
+                slotKeys_[slot] = idx;
+                slotUnique_[slot] = static_cast<uint32_t>(unique_.size());
+                unique_.push_back(idx);
+            }
+            inverse_[i] = slotUnique_[slot];
+        }
+    }
+
+    std::vector<size_t> unique_;
+    std::vector<uint32_t> inverse_;
+    std::vector<uint64_t> keys_;
+    std::vector<uint64_t> slotKeys_;
+    std::vector<uint32_t> slotUnique_;
+    double ratio_;       // Dedup ratio of the last deduplicated batch
+    size_t sinceProbe_;  // DEDUP_AUTO batches since the ratio was last measured
+};
+
+// Look up a batch of tokens of Dim-wide rows, applying rowOp to each row and
+// writing one result per token. Rows are prefetched prefetchAhead rows ahead
+// with the Prefetch policy. With deduplication rowOp runs once per unique
+// row, prefetching unique rows, and the results are scattered back to
+// every batch position through the inverse map. DEDUP_AUTO is resolved with
+// the deduplicator's chooseAuto(); batches larger than DEDUP_MAX_BATCH are
+// looked up without deduplication. Returns the strategy used.
+template <size_t Dim, typename Prefetch, typename RowOp>
+DedupStrategy dedupLookup(const std::vector<std::vector<double>>& matrix,
+                          const size_t* tokens, size_t n, DedupStrategy strategy,
+                          BatchDeduplicator& dedup, size_t prefetchAhead, RowOp rowOp,
+                          std::vector<double>& uniqueResults, double* results) {
+    if (strategy == DEDUP_AUTO) {
+        strategy = dedup.chooseAuto(n, Dim * sizeof(double));
+    }
+    if (strategy == DEDUP_NONE || n > DEDUP_MAX_BATCH) {
+        strategy = DEDUP_NONE;
+        for (size_t i = 0; i < n; i++) {
+            if (i + prefetchAhead < n) {
+                Prefetch::template issue<double, Dim>(&matrix[tokens[i + prefetchAhead]][0]);
+            }
+            results[i] = rowOp(matrix[tokens[i]]);
+        }
+        return strategy;
+    }
+
+    strategy = dedup.dedup(tokens, n, strategy);
+    const std::vector<size_t>& unique = dedup.unique();
+    const std::vector<uint32_t>& inverse = dedup.inverse();
+    uniqueResults.resize(unique.size());
+
+    for (size_t u = 0; u < unique.size(); u++) {
+        if (u + prefetchAhead < unique.size()) {
+            Prefetch::template issue<double, Dim>(&matrix[unique[u + prefetchAhead]][0]);
+        }
+        uniqueResults[u] = rowOp(matrix[unique[u]]);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        results[i] = uniqueResults[inverse[i]];
+    }
+    return strategy;
+}
+
+#endif // DEDUP_LOOKUP_HPP
@@ -0,0 +1,220 @@
+#ifndef EMBEDDING_BAG_HPP
+#define EMBEDDING_BAG_HPP
+
+#include <vector>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <functional> // For std::cref
+#include <x86intrin.h> // For AVX intrinsics
+#include "prefetch_pipeline.hpp" // Prefetch policies
+
+// Pooling applied over the rows of each bag
+enum PoolingMode {
+    POOL_SUM,
+    POOL_MEAN,
+    POOL_WEIGHTED_SUM,
+    POOL_MAX
+};
+
+// SIMD vector used for accumulation: AVX when available, scalar otherwise
+#if defined(__AVX__)
+typedef __m256d VecD;
+const size_t VEC_WIDTH = 4;
+inline VecD vecLoad(const double* p) { return _mm256_loadu_pd(p); }
+inline void vecStore(double* p, VecD v) { _mm256_storeu_pd(p, v); }
+inline VecD vecSet(double x) { return _mm256_set1_pd(x); }
+inline VecD vecAdd(VecD a, VecD b) { return _mm256_add_pd(a, b); }
+inline VecD vecMul(VecD a, VecD b) { return _mm256_mul_pd(a, b); }
+inline VecD vecMax(VecD a, VecD b) { return _mm256_max_pd(a, b); }
+#else
+typedef double VecD;
+const size_t VEC_WIDTH = 1;
+inline VecD vecLoad(const double* p) { return *p; }
+inline void vecStore(double* p, VecD v) { *p = v; }
+inline VecD vecSet(double x) { return x; }
+inline VecD vecAdd(VecD a, VecD b) { return a + b; }
+inline VecD vecMul(VecD a, VecD b) { return a * b; }
+inline VecD vecMax(VecD a, VecD b) { return a > b ? a : b; }
+#endif
+
+// Accumulators kept in registers per column block; wider rows are pooled
+// block by block, re-reading the bag's rows from cache for each block
+const size_t BAG_REG_VECS = 8;
+
+// CSR description of a batch of bags: bag b pools the rows
+// indices[offsets[b]] .. indices[offsets[b + 1] - 1]
+struct BagBatch {
+    const std::vector<size_t>& indices;
+    const std::vector<size_t>& offsets; // numBags + 1 entries
+    const std::vector<double>& weights; // One per index, POOL_WEIGHTED_SUM only
+};
+
+// Pool columns [Col, Col + NV * VEC_WIDTH) of the rows indices[begin..end)
+// into out. Only the first column block issues prefetches, with the Prefetch
+// policy; they run prefetchAhead indices ahead in the flat index array (up to
+// limit), so they cross into the following bags.
+template <PoolingMode Mode, size_t Cols, size_t NV, typename Prefetch>
+inline void poolBlock(const std::vector<std::vector<double>>& matrix, const BagBatch& batch,
+                      size_t begin, size_t end, size_t limit, size_t col,
+                      size_t prefetchAhead, bool issuePrefetch, double* out) {
+    VecD acc[NV];
+    for (size_t v = 0; v < NV; v++) {
+        acc[v] = vecSet(Mode == POOL_MAX ? -std::numeric_limits<double>::infinity() : 0.0);
+    }
+
+    for (size_t k = begin; k < end; k++) {
+        if (issuePrefetch && k + prefetchAhead < limit) {
+            Prefetch::template issue<double, Cols>(&matrix[batch.indices[k + prefetchAhead]][0]);
+        }
+        const double* row = &matrix[batch.indices[k]][col];
+        if (Mode == POOL_WEIGHTED_SUM) {
+            VecD w = vecSet(batch.weights[k]);
+            for (size_t v = 0; v < NV; v++) {
+                acc[v] = vecAdd(acc[v], vecMul(w, vecLoad(row + v * VEC_WIDTH)));
+            }
+        } else if (Mode == POOL_MAX) {
+            for (size_t v = 0; v < NV; v++) {
+                acc[v] = vecMax(acc[v], vecLoad(row + v * VEC_WIDTH));
+            }
+        } else {
+            for (size_t v = 0; v < NV; v++) {
+                acc[v] = vecAdd(acc[v], vecLoad(row + v * VEC_WIDTH));
+            }
+        }
+    }
+
+    if (Mode == POOL_MEAN && end > begin) {
+        VecD scale = vecSet(1.0 / (end - begin));
+        for (size_t v = 0; v < NV; v++) {
+            acc[v] = vecMul(acc[v], scale);
+        }
+    }
+    if (Mode == POOL_MAX && end == begin) {
+        for (size_t v = 0; v < NV; v++) {
+            acc[v] = vecSet(0.0); // Empty bags pool to zero
+        }
+    }
+    for (size_t v = 0; v < NV; v++) {
+        vecStore(out + col + v * VEC_WIDTH, acc[v]);
+    }
+}
+
+// Scalar pooling of the columns left over after the last full SIMD vector
+template <PoolingMode Mode>
+inline void poolTail(const std::vector<std::vector<double>>& matrix, const BagBatch& batch,
+                     size_t begin, size_t end, size_t col, size_t cols, double* out) {
+    for (size_t j = col; j < cols; j++) {
+        double acc = Mode == POOL_MAX ? -std::numeric_limits<double>::infinity() : 0.0;
+        for (size_t k = begin; k < end; k++) {
+            double x = matrix[batch.indices[k]][j];
+            if (Mode == POOL_WEIGHTED_SUM) {
+                acc += batch.weights[k] * x;
+            } else if (Mode == POOL_MAX) {
+                acc = std::max(acc, x);
+            } else {
+                acc += x;
+            }
+        }
+        if (Mode == POOL_MEAN && end > begin) {
+            acc *= 1.0 / (end - begin);
+        }
+        if (Mode == POOL_MAX && end == begin) {
+            acc = 0.0;
+        }
+        out[j] = acc;
+    }
+}
+
+// Walk the columns of one bag in register-sized blocks, unrolled at compile time
+template <PoolingMode Mode, size_t Cols, typename Prefetch, size_t Col, bool HasVec = (Cols - Col >= VEC_WIDTH)>
+struct ColumnBlocks {
+    static const size_t NV = (Cols - Col) / VEC_WIDTH < BAG_REG_VECS ? (Cols - Col) / VEC_WIDTH : BAG_REG_VECS;
+
+    static void run(const std::vector<std::vector<double>>& matrix, const BagBatch& batch,
+                    size_t begin, size_t end, size_t limit, size_t prefetchAhead, double* out) {
+        poolBlock<Mode, Cols, NV, Prefetch>(matrix, batch, begin, end, limit, Col, prefetchAhead, Col == 0, out);
+        ColumnBlocks<Mode, Cols, Prefetch, Col + NV * VEC_WIDTH>::run(matrix, batch, begin, end, limit, prefetchAhead, out);
+    }
+};
+
+template <PoolingMode Mode, size_t Cols, typename Prefetch, size_t Col>
+struct ColumnBlocks<Mode, Cols, Prefetch, Col, false> {
+    static void run(const std::vector<std::vector<double>>& matrix, const BagBatch& batch,
+                    size_t begin, size_t end, size_t limit, size_t prefetchAhead, double* out) {
+        if (Col == 0) {
+            // Rows narrower than one vector never reach poolBlock; prefetch here
+            for (size_t k = begin; k < end && k + prefetchAhead < limit; k++) {
+                Prefetch::template issue<double, Cols>(&matrix[batch.indices[k + prefetchAhead]][0]);
+            }
+        }
+        poolTail<Mode>(matrix, batch, begin, end, Col, Cols, out);
+    }
+};
+
+// Pool bags [bagBegin, bagEnd) into output
+template <PoolingMode Mode, size_t Cols, typename Prefetch>
+void embeddingBagRange(const std::vector<std::vector<double>>& matrix, const BagBatch& batch,
+                       size_t bagBegin, size_t bagEnd, size_t prefetchAhead,
+                       std::vector<double>& output) {
+    size_t limit = batch.offsets[bagEnd];
+    for (size_t bag = bagBegin; bag < bagEnd; bag++) {
+        ColumnBlocks<Mode, Cols, Prefetch, 0>::run(matrix, batch, batch.offsets[bag], batch.offsets[bag + 1],
+                                         limit, prefetchAhead, &output[bag * Cols]);
+    }
+}
+
+template <PoolingMode Mode, size_t Cols, typename Prefetch>
+void embeddingBagThreads(const std::vector<std::vector<double>>& matrix, const BagBatch& batch,
+                         size_t prefetchAhead, size_t numThreads, std::vector<double>& output) {
+    size_t numBags = batch.offsets.size() - 1;
+    if (numThreads <= 1 || numBags < numThreads) {
+        embeddingBagRange<Mode, Cols, Prefetch>(matrix, batch, 0, numBags, prefetchAhead, output);
+        return;
+    }
+
+    // Split bags so every thread pools about the same number of rows
+    std::vector<size_t> bounds(1, 0);
+    size_t totalRows = batch.offsets[numBags];
+    for (size_t t = 1; t < numThreads; t++) {
+        size_t target = totalRows * t / numThreads;
+        size_t bag = std::lower_bound(batch.offsets.begin(), batch.offsets.end(), target) - batch.offsets.begin();
+        bounds.push_back(std::max(bounds.back(), std::min(bag, numBags)));
+    }
+    bounds.push_back(numBags);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread(embeddingBagRange<Mode, Cols, Prefetch>, std::cref(matrix), std::cref(batch),
+                                      bounds[t], bounds[t + 1], prefetchAhead, std::ref(output)));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Pooled lookup over a CSR batch of bags (EmbeddingBag). Writes one pooled
+// row of Cols values per bag into output, resizing it as needed. Upcoming
+// rows are prefetched with the Prefetch policy (prefetch_pipeline.hpp).
+template <size_t Cols, typename Prefetch>
+void embeddingBag(const std::vector<std::vector<double>>& matrix, const BagBatch& batch,
+                  PoolingMode mode, size_t prefetchAhead, size_t numThreads,
+                  std::vector<double>& output) {
+    output.resize((batch.offsets.size() - 1) * Cols);
+    switch (mode) {
+        case POOL_SUM:
+            embeddingBagThreads<POOL_SUM, Cols, Prefetch>(matrix, batch, prefetchAhead, numThreads, output);
+            break;
+        case POOL_MEAN:
+            embeddingBagThreads<POOL_MEAN, Cols, Prefetch>(matrix, batch, prefetchAhead, numThreads, output);
+            break;
+        case POOL_WEIGHTED_SUM:
+            embeddingBagThreads<POOL_WEIGHTED_SUM, Cols, Prefetch>(matrix, batch, prefetchAhead, numThreads, output);
+            break;
+        case POOL_MAX:
+            embeddingBagThreads<POOL_MAX, Cols, Prefetch>(matrix, batch, prefetchAhead, numThreads, output);
+            break;
+    }
+}
+
+#endif // EMBEDDING_BAG_HPP
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <numeric> // For std::accumulate
+#include <cmath> // For std::sqrt
+#include <algorithm> // For std::max
+#include <thread> // For std::thread::hardware_concurrency
+#include "embedding_bag.hpp" // Pooled lookup kernels
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 25;        // GloVe embedding dimension
+const size_t PREFETCH_AHEAD = 11;  // Prefetch ahead distance in the flat index array
+const size_t NUM_RUNS = 10;        // Number of times to run each test
+
+// Bags touch whole rows, so every cache line of an upcoming row is prefetched
+typedef FullRowPrefetch<_MM_HINT_T0> BagPrefetch;
+
+const char* poolingName(PoolingMode mode) {
+    switch (mode) {
+        case POOL_SUM: return "sum";
+        case POOL_MEAN: return "mean";
+        case POOL_WEIGHTED_SUM: return "weighted sum";
+        case POOL_MAX: return "max";
+    }
+    return "unknown";
+}
+
+// Function to pool bags row by row without prefetching, SIMD or threads,
+// following the per-row regularAccess loop. The pooling mode is a template
+// parameter, as in the fused kernel, so the inner loop does not test it.
+template <PoolingMode Mode>
+void regularBagAccess(const std::vector<std::vector<double>>& matrix,
+                     const BagBatch& batch, std::vector<double>& output) {
+    size_t numBags = batch.offsets.size() - 1;
+    output.assign(numBags * NUM_COLS, 0.0);
+
+    for (size_t bag = 0; bag < numBags; bag++) {
+        double* out = &output[bag * NUM_COLS];
+        size_t begin = batch.offsets[bag];
+        size_t end = batch.offsets[bag + 1];
+        if (Mode == POOL_MAX && end > begin) {
+            // Start from the first row; empty bags stay zero
+            const auto& first = matrix[batch.indices[begin]];
+            for (size_t j = 0; j < NUM_COLS; j++) {
+                out[j] = first[j];
+            }
+            begin++;
+        }
+
+        for (size_t k = begin; k < end; k++) {
+            const auto& row = matrix[batch.indices[k]];
+            if (Mode == POOL_MAX) {
+                for (size_t j = 0; j < NUM_COLS; j++) {
+                    out[j] = std::max(out[j], row[j]);
+                }
+            } else if (Mode == POOL_WEIGHTED_SUM) {
+                double weight = batch.weights[k];
+                for (size_t j = 0; j < NUM_COLS; j++) {
+                    out[j] += weight * row[j];
+                }
+            } else {
+                for (size_t j = 0; j < NUM_COLS; j++) {
+                    out[j] += row[j];
+                }
+            }
+        }
+        if (Mode == POOL_MEAN && end > begin) {
+            for (size_t j = 0; j < NUM_COLS; j++) {
+                out[j] *= 1.0 / (end - begin);
+            }
+        }
+    }
+}
+
+void regularBagAccess(const std::vector<std::vector<double>>& matrix,
+                      const BagBatch& batch, PoolingMode mode,
+                      std::vector<double>& output) {
+    switch (mode) {
+        case POOL_SUM:
+            regularBagAccess<POOL_SUM>(matrix, batch, output);
+            break;
+        case POOL_MEAN:
+            regularBagAccess<POOL_MEAN>(matrix, batch, output);
+            break;
+        case POOL_WEIGHTED_SUM:
+            regularBagAccess<POOL_WEIGHTED_SUM>(matrix, batch, output);
+            break;
+        case POOL_MAX:
+            regularBagAccess<POOL_MAX>(matrix, batch, output);
+            break;
+    }
+}
+
+// Time NUM_RUNS calls of fn and return the mean and standard deviation in ms
+template <typename Fn>
+std::pair<double, double> timeRuns(Fn fn) {
+    std::vector<double> times;
+    for (size_t run = 0; run < NUM_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6);
+    }
+    double mean = std::accumulate(times.begin(), times.end(), 0.0) / NUM_RUNS;
+    double var = 0.0;
+    for (double t : times) {
+        var += std::pow(t - mean, 2);
+    }
+    return std::make_pair(mean, std::sqrt(var / NUM_RUNS));
+}
+
+int main() {
+    // Load GloVe embeddings
+    std::cout << "Loading GloVe embeddings..." << std::endl;
+    std::unordered_map<std::string, size_t> word_to_idx;
+    std::vector<std::vector<double>> matrix;
+
+    std::ifstream glove_file(GLOVE_PATH);
+    std::string line;
+    size_t idx = 0;
+
+    while (std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        std::vector<double> embedding(NUM_COLS);
+        for (size_t i = 0; i < NUM_COLS; i++) {
+            iss >> embedding[i];
+        }
+
+        word_to_idx[word] = idx;
+        matrix.push_back(embedding);
+        idx++;
+    }
+
+    // Load input words and split them into one bag per sentence
+    std::cout << "Loading input sentences..." << std::endl;
+    std::vector<size_t> indices;
+    std::vector<size_t> offsets(1, 0);
+    std::ifstream input_file(INPUT_PATH);
+    std::string word;
+
+    while (input_file >> word) {
+        if (word_to_idx.find(word) != word_to_idx.end()) {
+            indices.push_back(word_to_idx[word]);
+        }
+        char last = word[word.size() - 1];
+        if ((last == '.' || last == '?' || last == '!') && indices.size() > offsets.back()) {
+            offsets.push_back(indices.size());
+        }
+    }
+    if (indices.size() > offsets.back()) {
+        offsets.push_back(indices.size());
+    }
+
+    if (indices.empty()) {
+        std::cerr << "No valid words found in input file!" << std::endl;
+        return 1;
+    }
+
+    // Deterministic per-index weights for the weighted sum
+    std::mt19937 gen(573);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<double> weights(indices.size());
+    for (size_t k = 0; k < weights.size(); k++) {
+        weights[k] = dist(gen);
+    }
+
+    BagBatch batch = {indices, offsets, weights};
+    size_t numBags = offsets.size() - 1;
+    std::cout << "Bags: " << numBags << ", rows: " << indices.size()
+              << ", mean bag size: " << static_cast<double>(indices.size()) / numBags << std::endl;
+
+    std::vector<size_t> thread_counts(1, 1);
+    size_t hw_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t t = 2; t <= hw_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+
+    const PoolingMode modes[] = {POOL_SUM, POOL_MEAN, POOL_WEIGHTED_SUM, POOL_MAX};
+    for (PoolingMode mode : modes) {
+        std::cout << "\nPooling mode: " << poolingName(mode) << std::endl;
+
+        std::vector<double> output1, output2;
+        auto regular = timeRuns([&] { regularBagAccess(matrix, batch, mode, output1); });
+        std::cout << "Regular bag access time: " << regular.first << " ± " << regular.second << " ms" << std::endl;
+
+        for (size_t numThreads : thread_counts) {
+            auto pooled = timeRuns([&] {
+                embeddingBag<NUM_COLS, BagPrefetch>(matrix, batch, mode, PREFETCH_AHEAD, numThreads, output2);
+            });
+
+            double max_diff = 0.0;
+            for (size_t i = 0; i < output1.size(); i++) {
+                max_diff = std::max(max_diff, std::abs(output1[i] - output2[i]));
+            }
+            std::cout << "Fused embedding bag time (" << numThreads << " threads): "
+                      << pooled.first << " ± " << pooled.second << " ms"
+                      << ", speedup " << regular.first / pooled.first << "x"
+                      << ", results match " << (max_diff < 1e-10) << std::endl;
+        }
+    }
+
+    return 0;
+}
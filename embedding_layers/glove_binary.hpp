@@ -0,0 +1,89 @@
+#ifndef GLOVE_BINARY_HPP
+#define GLOVE_BINARY_HPP
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdio> // For std::rename, std::remove
+#include <sys/stat.h> // For stat
+
+// Binary GloVe layout: rows of numCols doubles, row-major with no header,
+// so row i starts at byte i * numCols * sizeof(double). The words are kept
+// alongside in a vocab file, one per line in row order.
+
+// Convert a text GloVe file into the binary layout. Both files are written
+// under a temporary name and renamed into place only once the conversion is
+// complete, so an interrupted or failed run never leaves a table that looks
+// converted. Returns the number of rows, or 0 if textPath cannot be read or
+// the output cannot be written.
+inline size_t convertGloveToBinary(const std::string& textPath, const std::string& binPath,
+                                   const std::string& vocabPath, size_t numCols) {
+    std::ifstream glove_file(textPath);
+    if (!glove_file.is_open()) {
+        return 0;
+    }
+    const std::string binTmp = binPath + ".tmp";
+    const std::string vocabTmp = vocabPath + ".tmp";
+    std::ofstream bin_file(binTmp, std::ios::binary);
+    std::ofstream vocab_file(vocabTmp);
+    std::string line;
+    std::vector<double> embedding(numCols);
+    size_t rows = 0;
+
+    while (bin_file && vocab_file && std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        for (size_t i = 0; i < numCols; i++) {
+            iss >> embedding[i];
+        }
+
+        bin_file.write(reinterpret_cast<const char*>(embedding.data()), numCols * sizeof(double));
+        vocab_file << word << '\n';
+        rows++;
+    }
+
+    bin_file.close();
+    vocab_file.close();
+    // The vocab is renamed last: it is what marks the conversion as done
+    bool complete = rows > 0 && !glove_file.bad() && bin_file && vocab_file;
+    if (!complete || std::rename(binTmp.c_str(), binPath.c_str()) != 0 ||
+        std::rename(vocabTmp.c_str(), vocabPath.c_str()) != 0) {
+        std::remove(binTmp.c_str());
+        std::remove(vocabTmp.c_str());
+        return 0;
+    }
+    return rows;
+}
+
+// Load the vocab of a table written by convertGloveToBinary. Returns the
+// number of rows, or 0 if there is no complete conversion yet: the vocab is
+// missing or empty, or the binary file is not exactly rows * numCols doubles.
+inline size_t loadVocab(const std::string& vocabPath, const std::string& binPath, size_t numCols,
+                        std::unordered_map<std::string, size_t>& word_to_idx) {
+    word_to_idx.clear();
+    std::ifstream vocab_file(vocabPath);
+    if (!vocab_file) {
+        return 0;
+    }
+    std::string word;
+    size_t idx = 0;
+    while (std::getline(vocab_file, word)) {
+        word_to_idx[word] = idx;
+        idx++;
+    }
+
+    struct stat bin_stat;
+    if (idx == 0 || stat(binPath.c_str(), &bin_stat) != 0 ||
+        static_cast<size_t>(bin_stat.st_size) != idx * numCols * sizeof(double)) {
+        word_to_idx.clear();
+        return 0;
+    }
+    return idx;
+}
+
+#endif // GLOVE_BINARY_HPP
@@ -0,0 +1,251 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <x86intrin.h> // For _mm_prefetch
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <numeric> // For std::accumulate
+#include <cmath> // For std::sqrt
+#include <algorithm> // For std::min
+#include "ngram.hpp" // Include the n-gram model header
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 25;        // GloVe embedding dimension
+const int NGRAM_ORDER = 3;         // Order of the n-gram model
+const size_t MAX_STREAMS = 256;    // Largest number of concurrent streams tested
+const size_t NUM_RUNS = 5;         // Number of times to run each test
+
+// How each stream decides which row to prefetch for its next lookup
+enum PredictorKind {
+    KNOWN_NEXT,  // The stream's next token is already known (e.g. prefill)
+    NEXT_WORD,   // Most likely next word given the current one
+    NGRAM        // Backoff n-gram over the stream's own context
+};
+
+const char* predictorName(PredictorKind kind) {
+    switch (kind) {
+        case KNOWN_NEXT: return "known-next";
+        case NEXT_WORD: return "next-word";
+        case NGRAM: return "n-gram";
+    }
+    return "unknown";
+}
+
+// Per-stream state. Every stream keeps its own position, predictor context
+// and partial result so streams stay independent of each other.
+struct StreamState {
+    size_t pos;                  // Next position in accessPattern to look up
+    size_t end;                  // One past the last position of this stream
+    std::vector<size_t> context; // N-gram context of this stream
+    double result;               // Partial sum of this stream's row results
+};
+
+// Prefetch every cache line of a row
+inline void prefetchRow(const std::vector<double>& row) {
+    FullRowPrefetch<_MM_HINT_T0>::issue<double, NUM_COLS>(&row[0]);
+}
+
+// Average of squared values in a row
+inline double rowOp(const std::vector<double>& row) {
+    return MeanSquareReduce::apply<double, NUM_COLS>(&row[0]);
+}
+
+// Function to perform row operations without prefetching
+double regularAccess(const std::vector<std::vector<double>>& matrix,
+                    const std::vector<size_t>& accessPattern) {
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
+}
+
+// Function to perform row operations over numStreams independent streams,
+// interleaving their lookups round-robin (group prefetching / AMAC style).
+// A stream's next row is prefetched right after its current row is consumed,
+// and only consumed on the stream's next turn, so the lookups of all other
+// active streams are in flight while it waits on memory.
+double interleavedAccess(const std::vector<std::vector<double>>& matrix,
+                         const std::vector<size_t>& accessPattern,
+                         size_t numStreams,
+                         PredictorKind predictor,
+                         const std::unordered_map<size_t, size_t>& mostLikelyNext,
+                         const std::vector<NGram>& ngramModels) {
+    // Split accessPattern into numStreams contiguous token streams
+    size_t chunk = (accessPattern.size() + numStreams - 1) / numStreams;
+    std::vector<StreamState> streams;
+    for (size_t begin = 0; begin < accessPattern.size(); begin += chunk) {
+        StreamState stream;
+        stream.pos = begin;
+        stream.end = std::min(begin + chunk, accessPattern.size());
+        stream.result = 0.0;
+        streams.push_back(stream);
+    }
+
+    // Issue the first row of every stream before any of them is consumed
+    std::vector<size_t> active;
+    for (size_t s = 0; s < streams.size(); s++) {
+        prefetchRow(matrix[accessPattern[streams[s].pos]]);
+        active.push_back(s);
+    }
+
+    while (!active.empty()) {
+        for (size_t a = 0; a < active.size();) {
+            StreamState& stream = streams[active[a]];
+            size_t current = accessPattern[stream.pos];
+
+            // Consume the row prefetched on this stream's previous turn
+            stream.result += rowOp(matrix[current]);
+            stream.pos++;
+
+            if (stream.pos == stream.end) {
+                // Stream is exhausted; drop it from the rotation
+                active[a] = active.back();
+                active.pop_back();
+                continue;
+            }
+
+            // Issue the row this stream will need on its next turn
+            size_t next = matrix.size();
+            if (predictor == KNOWN_NEXT) {
+                next = accessPattern[stream.pos];
+            } else if (predictor == NEXT_WORD) {
+                auto it = mostLikelyNext.find(current);
+                if (it != mostLikelyNext.end()) {
+                    next = it->second;
+                }
+            } else {
+                if (stream.context.size() >= NGRAM_ORDER - 1) {
+                    stream.context.erase(stream.context.begin());
+                }
+                stream.context.push_back(current);
+                next = predictNextWord(ngramModels, stream.context);
+            }
+            if (next < matrix.size()) {
+                prefetchRow(matrix[next]);
+            }
+            a++;
+        }
+    }
+
+    double result = 0.0;
+    for (size_t s = 0; s < streams.size(); s++) {
+        result += streams[s].result;
+    }
+    return result / accessPattern.size();
+}
+
+int main() {
+    // Load GloVe embeddings
+    std::cout << "Loading GloVe embeddings..." << std::endl;
+    std::unordered_map<std::string, size_t> word_to_idx;
+    std::vector<std::vector<double>> matrix;
+
+    std::ifstream glove_file(GLOVE_PATH);
+    std::string line;
+    size_t idx = 0;
+
+    while (std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        std::vector<double> embedding(NUM_COLS);
+        for (size_t i = 0; i < NUM_COLS; i++) {
+            iss >> embedding[i];
+        }
+
+        word_to_idx[word] = idx;
+        matrix.push_back(embedding);
+        idx++;
+    }
+
+    // Load input words and create access pattern
+    std::cout << "Loading input words..." << std::endl;
+    std::vector<size_t> accessPattern;
+    std::ifstream input_file(INPUT_PATH);
+    std::string word;
+
+    while (input_file >> word) {
+        if (word_to_idx.find(word) != word_to_idx.end()) {
+            accessPattern.push_back(word_to_idx[word]);
+        }
+    }
+
+    if (accessPattern.empty()) {
+        std::cerr << "No valid words found in input file!" << std::endl;
+        return 1;
+    }
+
+    // Build the most likely next word mapping
+    std::cout << "Building most likely next word mapping..." << std::endl;
+    std::unordered_map<size_t, std::unordered_map<size_t, size_t>> transition_counts;
+    for (size_t i = 0; i + 1 < accessPattern.size(); i++) {
+        transition_counts[accessPattern[i]][accessPattern[i + 1]]++;
+    }
+
+    std::unordered_map<size_t, size_t> mostLikelyNext;
+    for (const auto& pair : transition_counts) {
+        size_t max_count = 0;
+        size_t likely_next = 0;
+        for (const auto& inner_pair : pair.second) {
+            if (inner_pair.second > max_count) {
+                max_count = inner_pair.second;
+                likely_next = inner_pair.first;
+            }
+        }
+        mostLikelyNext[pair.first] = likely_next;
+    }
+
+    // Build the n-gram model
+    std::cout << "Building " << NGRAM_ORDER << "-gram model..." << std::endl;
+    std::vector<NGram> ngramModels(NGRAM_ORDER);
+    buildKGramModels(ngramModels, accessPattern, NGRAM_ORDER);
+
+    // Sequential baseline over the same tokens
+    std::vector<double> regular_times;
+    double result1 = 0.0;
+    for (size_t run = 0; run < NUM_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        result1 = regularAccess(matrix, accessPattern);
+        auto end = std::chrono::steady_clock::now();
+        regular_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6);
+    }
+    double reg_mean = std::accumulate(regular_times.begin(), regular_times.end(), 0.0) / NUM_RUNS;
+    std::cout << "\nRegular access time: " << reg_mean << " ms" << std::endl;
+
+    const PredictorKind predictors[] = {KNOWN_NEXT, NEXT_WORD, NGRAM};
+
+    // Sweep the number of concurrent streams B = 1, 2, 4, ..., MAX_STREAMS
+    for (size_t numStreams = 1; numStreams <= MAX_STREAMS; numStreams *= 2) {
+        std::cout << "\nTesting B = " << numStreams << " streams" << std::endl;
+
+        for (PredictorKind predictor : predictors) {
+            std::vector<double> interleaved_times;
+            double result2 = 0.0;
+
+            for (size_t run = 0; run < NUM_RUNS; run++) {
+                auto start = std::chrono::steady_clock::now();
+                result2 = interleavedAccess(matrix, accessPattern, numStreams, predictor,
+                                            mostLikelyNext, ngramModels);
+                auto end = std::chrono::steady_clock::now();
+                interleaved_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6);
+            }
+
+            double mean = std::accumulate(interleaved_times.begin(), interleaved_times.end(), 0.0) / NUM_RUNS;
+            double var = 0.0;
+            for (size_t i = 0; i < NUM_RUNS; i++) {
+                var += std::pow(interleaved_times[i] - mean, 2);
+            }
+            var /= NUM_RUNS;
+
+            std::cout << "  " << predictorName(predictor) << ": " << mean << " ± " << std::sqrt(var) << " ms"
+                      << ", speedup " << reg_mean / mean << "x"
+                      << ", results match " << (std::abs(result1 - result2) < 1e-10) << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <unordered_map>
 #include <string>
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
 
 // Global constants
 const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
@@ -16,57 +17,15 @@ const size_t NUM_COLS = 25;        // GloVe embedding dimension
 // Function to perform row operations without prefetching
 double regularAccess(const std::vector<std::vector<double>>& matrix, 
                     const std::vector<size_t>& accessPattern) {
-    double result = 0.0;
-    
-    for (size_t i = 0; i < accessPattern.size(); i++) {
-        //if (i % (accessPattern.size() / 10) == 0) {
-       //     std::cout << "Regular access: " << (i * 100 / accessPattern.size()) << "% complete" << std::endl;
-       // }
-        
-        const auto& row = matrix[accessPattern[i]];
-        // Compute average of squared values in row
-        double row_sum = 0.0;
-        for (size_t j = 0; j < NUM_COLS; j++) {
-            row_sum += row[j] * row[j];
-        }
-        result += row_sum / NUM_COLS;
-    }
-    return result / accessPattern.size();
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
 }
 
 // Function to perform row operations with learnable prefetching
 double learnableAccess(const std::vector<std::vector<double>>& matrix, 
                       const std::vector<size_t>& accessPattern,
                       const std::unordered_map<size_t, size_t>& mostLikelyNext) {
-    double result = 0.0;
-    
-    for (size_t i = 0; i < accessPattern.size(); i++) {
-        //if (i % (accessPattern.size() / 10) == 0) {
-       //     std::cout << "Learnable access: " << (i * 100 / accessPattern.size()) << "% complete" << std::endl;
-       // }
-        
-        // Determine the next index to prefetch based on the most likely next word
-        if (i < accessPattern.size() - 1) {
-            size_t current_word = accessPattern[i];
-            auto it = mostLikelyNext.find(current_word);
-            if (it != mostLikelyNext.end()) {
-                size_t next_word = it->second;
-                if (next_word < matrix.size()) {
-                    const char* next_row = reinterpret_cast<const char*>(&matrix[next_word][0]);
-                    _mm_prefetch(next_row, _MM_HINT_T0);
-                }
-            }
-        }
-        
-        const auto& row = matrix[accessPattern[i]];
-        // Compute average of squared values in row
-        double row_sum = 0.0;
-        for (size_t j = 0; j < NUM_COLS; j++) {
-            row_sum += row[j] * row[j];
-        }
-        result += row_sum / NUM_COLS;
-    }
-    return result / accessPattern.size();
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, FirstLinePrefetch<_MM_HINT_T0> >(
+        matrix, accessPattern, NextWordPredictor(mostLikelyNext));
 }
 
 int main() {
@@ -0,0 +1,28 @@
+#ifndef NGRAM_PREDICTOR_HPP
+#define NGRAM_PREDICTOR_HPP
+
+#include <vector>
+#include "ngram.hpp" // For predictNextWord
+#include "prefetch_pipeline.hpp" // Predictor policy interface
+
+// N-gram Predictor policy for pipelineAccess, kept out of
+// prefetch_pipeline.hpp so the core pipeline does not depend on the n-gram model.
+
+// Backoff n-gram over the last Order - 1 accessed words
+template <int Order>
+struct NGramPredictor {
+    const std::vector<NGram>& models;
+    std::vector<size_t> context;
+
+    explicit NGramPredictor(const std::vector<NGram>& m) : models(m) {}
+    size_t end(size_t n) const { return n; }
+    size_t predict(const std::vector<size_t>& pattern, size_t i) {
+        if (context.size() >= static_cast<size_t>(Order - 1)) {
+            context.erase(context.begin());
+        }
+        context.push_back(pattern[i]);
+        return predictNextWord(models, context);
+    }
+};
+
+#endif // NGRAM_PREDICTOR_HPP
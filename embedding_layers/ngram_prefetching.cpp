@@ -9,6 +9,8 @@
 #include <string>
 #include <cmath> // For std::abs
 #include "ngram.hpp" // Include the n-gram model header
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
+#include "ngram_predictor.hpp" // N-gram Predictor policy
 
 // Global constants
 const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
@@ -19,64 +21,15 @@ const int NGRAM_ORDER = 3;         // Order of the n-gram model
 // Function to perform row operations without prefetching
 double regularAccess(const std::vector<std::vector<double>>& matrix, 
                     const std::vector<size_t>& accessPattern) {
-    double result = 0.0;
-    
-    for (size_t i = 0; i < accessPattern.size(); i++) {
-        if (i % (accessPattern.size() / 10) == 0) {
-            std::cout << "Regular access: " << (i * 100 / accessPattern.size()) << "% complete" << std::endl;
-        }
-        
-        const auto& row = matrix[accessPattern[i]];
-        // Compute average of squared values in row
-        double row_sum = 0.0;
-        for (size_t j = 0; j < NUM_COLS; j++) {
-            row_sum += row[j] * row[j];
-        }
-        result += row_sum / NUM_COLS;
-    }
-    return result / accessPattern.size();
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
 }
 
-// Function to perform row operations with embedding-based prefetching
+// Function to perform row operations with n-gram based prefetching
 double ngram_prefetch(const std::vector<std::vector<double>>& matrix, 
                         const std::vector<size_t>& accessPattern,
-                        const std::vector<NGram>& ngramModels,
-                        const std::vector<size_t>& tokens) {
-    double result = 0.0;
-    
-    // Convert accessPattern indices back to tokens for n-gram usage
-    // Assuming 'tokens' vector maps indices to actual tokens
-    std::vector<size_t> context;
-    
-    for (size_t i = 0; i < accessPattern.size(); i++) {
-        if (i % (accessPattern.size() / 10) == 0) {
-            std::cout << "Embedding prefetch access: " << (i * 100 / accessPattern.size()) << "% complete" << std::endl;
-        }
-        
-        // Update context
-        if (context.size() >= NGRAM_ORDER - 1) {
-            context.erase(context.begin());
-        }
-        context.push_back(accessPattern[i]);
-        
-        // Predict next word using n-gram model
-        size_t predicted_next = predictNextWord(ngramModels, context);
-        
-        // Prefetch the predicted next row if valid
-        if (predicted_next < matrix.size()) {
-            const char* next_row = reinterpret_cast<const char*>(&matrix[predicted_next][0]);
-            _mm_prefetch(next_row, _MM_HINT_T0);
-        }
-        
-        const auto& row = matrix[accessPattern[i]];
-        // Compute average of squared values in row
-        double row_sum = 0.0;
-        for (size_t j = 0; j < NUM_COLS; j++) {
-            row_sum += row[j] * row[j];
-        }
-        result += row_sum / NUM_COLS;
-    }
-    return result / accessPattern.size();
+                        const std::vector<NGram>& ngramModels) {
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, FirstLinePrefetch<_MM_HINT_T0> >(
+        matrix, accessPattern, NGramPredictor<NGRAM_ORDER>(ngramModels));
 }
 
 int main() {
@@ -164,7 +117,7 @@ int main() {
     // Test embedding-based prefetch access
     std::cout << "Testing ngram prefetch access..." << std::endl;
     start = std::chrono::steady_clock::now();
-    double result2 = ngram_prefetch(matrix, accessPattern, ngramModels, tokens);
+    double result2 = ngram_prefetch(matrix, accessPattern, ngramModels);
     end = std::chrono::steady_clock::now();
     auto duration2 = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
     
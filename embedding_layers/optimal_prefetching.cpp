@@ -9,6 +9,7 @@
     #include <string>
     #include <numeric> // For std::accumulate
     #include <cmath> // For std::sqrt
+    #include "prefetch_pipeline.hpp" // Policy-based lookup kernels
 
     // Global constants
     const std::string GLOVE_PATH = "data/glove.840B.300d.txt";
@@ -21,73 +22,17 @@
     // Function to perform row operations without prefetching
     double regularAccess(const std::vector<std::vector<double>>& matrix, 
                         const std::vector<size_t>& accessPattern) {
-        double result = 0.0;
-        
-        for (size_t i = 0; i < accessPattern.size(); i++) {
-            //if (i % (accessPattern.size() / 10) == 0) {
-            //    std::cout << "Regular access: " << (i * 100 / accessPattern.size()) << "% complete" << std::endl;
-            //}
-            
-            const auto& row = matrix[accessPattern[i]];
-            // Compute dot product NUM_COLS times
-            double row_sum = 0.0;
-            for (size_t n = 0; n < 2; n++) {
-                double dot_product = 0.0;
-                for (size_t j = 0; j < NUM_COLS; j++) {
-                    dot_product += row[j] * row[j];
-                }
-                row_sum += dot_product;
-            }
-            result += row_sum / NUM_COLS;
-        }
-        return result / accessPattern.size();
+        return pipelineAccess<double, NUM_COLS, DoubleDotReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
     }
-    
+
     // Function to perform row operations with prefetching
     double prefetchedAccess(const std::vector<std::vector<double>>& matrix, 
                            const std::vector<size_t>& accessPattern,
                            size_t prefetch_ahead) {
-        double result = 0.0;
-        
-        // Handle first chunk with prefetching
-        size_t i = 0;
-        for (; i < accessPattern.size() - prefetch_ahead; i++) {
-            const char* next_row = reinterpret_cast<const char*>(&matrix[accessPattern[i + prefetch_ahead]][0]);
-            _mm_prefetch(next_row, _MM_HINT_T0);
-            //_MM_HINT_T0: Prefetch into all levels of the cache.
-            //_MM_HINT_T1: Prefetch into L2 cache only.
-            //_MM_HINT_T2: Prefetch into L1 cache only.
-            //_MM_HINT_NTA: Do not prefetch.
-            
-            const auto& row = matrix[accessPattern[i]];
-            double row_sum = 0.0;
-            for (size_t n = 0; n < 2; n++) {
-                double dot_product = 0.0;
-                for (size_t j = 0; j < NUM_COLS; j++) {
-                    dot_product += row[j] * row[j];
-                }
-                row_sum += dot_product;
-            }
-            result += row_sum / NUM_COLS;
-        }
-        
-        // Handle remaining elements without prefetching
-        for (; i < accessPattern.size(); i++) {
-            const auto& row = matrix[accessPattern[i]];
-            double row_sum = 0.0;
-            for (size_t n = 0; n < NUM_COLS; n++) {
-                double dot_product = 0.0;
-                for (size_t j = 0; j < NUM_COLS; j++) {
-                    dot_product += row[j] * row[j];
-                }
-                row_sum += dot_product;
-            }
-            result += row_sum / NUM_COLS;
-        }
-        
-        return result / accessPattern.size();
+        return pipelineAccess<double, NUM_COLS, DoubleDotReduce, FirstLinePrefetch<_MM_HINT_T0> >(
+            matrix, accessPattern, RuntimeDistancePredictor(prefetch_ahead));
     }
-    
+
     int main() {
         // Load GloVe embeddings
         std::cout << "Loading GloVe embeddings..." << std::endl;
@@ -0,0 +1,226 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <x86intrin.h> // For _mm_prefetch
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <cmath> // For std::abs
+#include "ngram.hpp" // Include the n-gram model header
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
+#include "ngram_predictor.hpp" // N-gram Predictor policy
+#include "dedup_lookup.hpp" // Deduplicated batch lookup
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 25;        // GloVe embedding dimension
+const size_t PREFETCH_AHEAD = 11;  // Fixed prefetch ahead distance
+const size_t PREFETCH_AHEAD_END = 20; // End of the runtime distance range checked
+const int NGRAM_ORDER = 3;         // Order of the n-gram model
+const size_t WIDE_COLS = 300;      // Row width of the 300 d benchmarks (tiled 25 d rows)
+const size_t DEDUP_BATCH = 4096;   // Batch size of the deduplicated lookups checked
+const double DEDUP_TOLERANCE = 1e-10; // Allowed error of the dedup mean (see dedupMatches)
+
+// Hand-written baseline of the prefetch-ahead and coroutine benchmarks
+template <size_t Dim>
+double regularDoubleDotAccess(const std::vector<std::vector<double>>& matrix,
+                              const std::vector<size_t>& accessPattern) {
+    double result = 0.0;
+
+    for (size_t i = 0; i < accessPattern.size(); i++) {
+        const auto& row = matrix[accessPattern[i]];
+        double row_sum = 0.0;
+        for (size_t n = 0; n < 2; n++) {
+            double dot_product = 0.0;
+            for (size_t j = 0; j < Dim; j++) {
+                dot_product += row[j] * row[j];
+            }
+            row_sum += dot_product;
+        }
+        result += row_sum / Dim;
+    }
+    return result / accessPattern.size();
+}
+
+// Hand-written baseline of the next-word, n-gram, interleaved, dedup and PQ benchmarks
+template <size_t Dim>
+double regularMeanSquareAccess(const std::vector<std::vector<double>>& matrix,
+                               const std::vector<size_t>& accessPattern) {
+    double result = 0.0;
+
+    for (size_t i = 0; i < accessPattern.size(); i++) {
+        const auto& row = matrix[accessPattern[i]];
+        double row_sum = 0.0;
+        for (size_t j = 0; j < Dim; j++) {
+            row_sum += row[j] * row[j];
+        }
+        result += row_sum / Dim;
+    }
+    return result / accessPattern.size();
+}
+
+// Check the deduplicated batch lookups (dedup_batch_lookup.cpp) of every
+// token. Each token's result must be bit-identical to Reduce on its row.
+// Their mean is summed in a separate loop that -ffast-math is free to
+// vectorize, so it is only required to be within DEDUP_TOLERANCE of the
+// baseline, like the benchmarks' "Results match".
+template <typename Reduce, size_t Dim>
+bool dedupMatches(const std::vector<std::vector<double>>& matrix,
+                  const std::vector<size_t>& accessPattern, DedupStrategy strategy,
+                  double baseline) {
+    BatchDeduplicator dedup;
+    std::vector<double> uniqueResults;
+    std::vector<double> tokenResults(accessPattern.size());
+    auto rowOp = [](const std::vector<double>& row) { return Reduce::template apply<double, Dim>(&row[0]); };
+
+    for (size_t begin = 0; begin < accessPattern.size(); begin += DEDUP_BATCH) {
+        size_t n = std::min(DEDUP_BATCH, accessPattern.size() - begin);
+        dedupLookup<Dim, FirstLinePrefetch<_MM_HINT_T0> >(matrix, &accessPattern[begin], n, strategy, dedup,
+                                                          PREFETCH_AHEAD, rowOp, uniqueResults, &tokenResults[begin]);
+    }
+
+    bool identical = true;
+    double result = 0.0;
+    for (size_t i = 0; i < tokenResults.size(); i++) {
+        identical = identical && tokenResults[i] == rowOp(matrix[accessPattern[i]]);
+        result += tokenResults[i];
+    }
+    return identical && std::abs(result / accessPattern.size() - baseline) < DEDUP_TOLERANCE;
+}
+
+// Run every strategy with the given Reduce policy and row width and compare
+// each pipeline result bit for bit with the hand-written baseline, and the
+// dedup paths as in dedupMatches. Returns the number of mismatches.
+template <typename Reduce, size_t Dim>
+size_t checkStrategies(const std::string& reduceName, double baseline,
+                       const std::vector<std::vector<double>>& matrix,
+                       const std::vector<size_t>& accessPattern,
+                       const std::unordered_map<size_t, size_t>& mostLikelyNext,
+                       const std::vector<NGram>& ngramModels) {
+    typedef FirstLinePrefetch<_MM_HINT_T0> FirstLine;
+    typedef FullRowPrefetch<_MM_HINT_T0> FullRow;
+
+    std::vector<std::pair<std::string, double>> results;
+    results.push_back(std::make_pair("regular",
+        pipelineAccess<double, Dim, Reduce, NoPrefetch>(matrix, accessPattern, NoPredictor())));
+    results.push_back(std::make_pair("fixed distance",
+        pipelineAccess<double, Dim, Reduce, FirstLine>(matrix, accessPattern, FixedDistancePredictor<PREFETCH_AHEAD>())));
+    results.push_back(std::make_pair("fixed distance, full row",
+        pipelineAccess<double, Dim, Reduce, FullRow>(matrix, accessPattern, FixedDistancePredictor<PREFETCH_AHEAD>())));
+    for (size_t d = 1; d <= PREFETCH_AHEAD_END; d++) {
+        results.push_back(std::make_pair("runtime distance " + std::to_string(d),
+            pipelineAccess<double, Dim, Reduce, FirstLine>(matrix, accessPattern, RuntimeDistancePredictor(d))));
+    }
+    results.push_back(std::make_pair("next word",
+        pipelineAccess<double, Dim, Reduce, FirstLine>(matrix, accessPattern, NextWordPredictor(mostLikelyNext))));
+    results.push_back(std::make_pair("n-gram",
+        pipelineAccess<double, Dim, Reduce, FirstLine>(matrix, accessPattern, NGramPredictor<NGRAM_ORDER>(ngramModels))));
+
+    size_t mismatches = 0;
+    std::cout << "\n" << reduceName << " baseline: " << baseline << std::endl;
+    for (const auto& result : results) {
+        bool identical = result.second == baseline;
+        mismatches += identical ? 0 : 1;
+        std::cout << "  " << result.first << ": bit-identical " << identical << std::endl;
+    }
+
+    const DedupStrategy strategies[] = {DEDUP_NONE, DEDUP_SORT, DEDUP_HASH};
+    const char* names[] = {"none", "sort", "hash"};
+    for (size_t s = 0; s < 3; s++) {
+        bool match = dedupMatches<Reduce, Dim>(matrix, accessPattern, strategies[s], baseline);
+        mismatches += match ? 0 : 1;
+        std::cout << "  dedup " << names[s] << ": per-token bit-identical, mean within "
+                  << DEDUP_TOLERANCE << " " << match << std::endl;
+    }
+    return mismatches;
+}
+
+int main() {
+    // Load GloVe embeddings
+    std::cout << "Loading GloVe embeddings..." << std::endl;
+    std::unordered_map<std::string, size_t> word_to_idx;
+    std::vector<std::vector<double>> matrix;
+
+    std::ifstream glove_file(GLOVE_PATH);
+    std::string line;
+    size_t idx = 0;
+
+    while (std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        std::vector<double> embedding(NUM_COLS);
+        for (size_t i = 0; i < NUM_COLS; i++) {
+            iss >> embedding[i];
+        }
+
+        word_to_idx[word] = idx;
+        matrix.push_back(embedding);
+        idx++;
+    }
+
+    // Load input words and create access pattern
+    std::cout << "Loading input words..." << std::endl;
+    std::vector<size_t> accessPattern;
+    std::ifstream input_file(INPUT_PATH);
+    std::string word;
+
+    while (input_file >> word) {
+        if (word_to_idx.find(word) != word_to_idx.end()) {
+            accessPattern.push_back(word_to_idx[word]);
+        }
+    }
+
+    if (accessPattern.empty()) {
+        std::cerr << "No valid words found in input file!" << std::endl;
+        return 1;
+    }
+
+    // Build the most likely next word mapping
+    std::unordered_map<size_t, std::unordered_map<size_t, size_t>> transition_counts;
+    for (size_t i = 0; i + 1 < accessPattern.size(); i++) {
+        transition_counts[accessPattern[i]][accessPattern[i + 1]]++;
+    }
+
+    std::unordered_map<size_t, size_t> mostLikelyNext;
+    for (const auto& pair : transition_counts) {
+        size_t max_count = 0;
+        size_t likely_next = 0;
+        for (const auto& inner_pair : pair.second) {
+            if (inner_pair.second > max_count) {
+                max_count = inner_pair.second;
+                likely_next = inner_pair.first;
+            }
+        }
+        mostLikelyNext[pair.first] = likely_next;
+    }
+
+    // Build the n-gram model
+    std::vector<NGram> ngramModels(NGRAM_ORDER);
+    buildKGramModels(ngramModels, accessPattern, NGRAM_ORDER);
+
+    // 300 d rows for the Dim = 300 instantiations, each a 25 d row tiled
+    std::vector<std::vector<double>> wide(matrix.size(), std::vector<double>(WIDE_COLS));
+    for (size_t r = 0; r < matrix.size(); r++) {
+        for (size_t j = 0; j < WIDE_COLS; j++) {
+            wide[r][j] = matrix[r][j % NUM_COLS];
+        }
+    }
+
+    size_t mismatches = 0;
+    mismatches += checkStrategies<DoubleDotReduce, NUM_COLS>("Double dot", regularDoubleDotAccess<NUM_COLS>(matrix, accessPattern),
+                                                             matrix, accessPattern, mostLikelyNext, ngramModels);
+    mismatches += checkStrategies<MeanSquareReduce, NUM_COLS>("Mean square", regularMeanSquareAccess<NUM_COLS>(matrix, accessPattern),
+                                                              matrix, accessPattern, mostLikelyNext, ngramModels);
+    mismatches += checkStrategies<DoubleDotReduce, WIDE_COLS>("Double dot, 300 d", regularDoubleDotAccess<WIDE_COLS>(wide, accessPattern),
+                                                              wide, accessPattern, mostLikelyNext, ngramModels);
+    mismatches += checkStrategies<MeanSquareReduce, WIDE_COLS>("Mean square, 300 d", regularMeanSquareAccess<WIDE_COLS>(wide, accessPattern),
+                                                               wide, accessPattern, mostLikelyNext, ngramModels);
+
+    std::cout << "\nAll strategies match: " << (mismatches == 0) << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
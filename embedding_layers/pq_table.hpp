@@ -0,0 +1,248 @@
+#ifndef PQ_TABLE_HPP
+#define PQ_TABLE_HPP
+
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <limits>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <x86intrin.h> // For _mm_prefetch and AVX intrinsics
+
+const size_t PQ_CENTROIDS = 256; // One byte per subvector code
+
+// Product-quantized embedding table. Every row is split into numSub
+// subvectors of subDim values; each subvector is stored as the one-byte index
+// of its nearest centroid in that subspace's 256-entry codebook. A lookup
+// touches numSub bytes of codes plus codebooks small enough to stay in L1/L2.
+class PQTable {
+public:
+    PQTable() : numRows_(0), numCols_(0), numSub_(0), subDim_(0) {}
+
+    // Train one codebook per subspace with k-means on trainRows randomly
+    // sampled rows, then encode every row. numCols must be a multiple of numSub.
+    void build(const std::vector<std::vector<double>>& matrix, size_t numSub,
+               size_t trainRows, size_t iterations, size_t numThreads, unsigned seed) {
+        if (matrix.empty() || numSub == 0 || matrix[0].size() % numSub != 0) {
+            throw std::invalid_argument("PQTable::build: numCols must be a non-zero multiple of numSub");
+        }
+        numRows_ = matrix.size();
+        numCols_ = matrix[0].size();
+        numSub_ = numSub;
+        subDim_ = numCols_ / numSub_;
+        codebooks_.assign(numSub_ * PQ_CENTROIDS * subDim_, 0.0f);
+        codes_.assign(numRows_ * numSub_, 0);
+
+        std::mt19937 gen(seed);
+        std::vector<size_t> sample(std::min(trainRows, numRows_));
+        std::uniform_int_distribution<size_t> pick(0, numRows_ - 1);
+        for (size_t s = 0; s < sample.size(); s++) {
+            sample[s] = sample.size() == numRows_ ? s : pick(gen);
+        }
+
+        // Subspaces are independent: train them on separate threads
+        parallelFor(numSub_, numThreads, [&](size_t begin, size_t end) {
+            for (size_t m = begin; m < end; m++) {
+                trainSubspace(matrix, sample, m, iterations, seed + static_cast<unsigned>(m));
+            }
+        });
+
+        parallelFor(numRows_, numThreads, [&](size_t begin, size_t end) {
+            for (size_t r = begin; r < end; r++) {
+                for (size_t m = 0; m < numSub_; m++) {
+                    codes_[r * numSub_ + m] = static_cast<uint8_t>(
+                        nearestCentroid(&matrix[r][m * subDim_], m));
+                }
+            }
+        });
+        buildNormTable();
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        uint64_t header[3] = {numRows_, numCols_, numSub_};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(codebooks_.data()), codebooks_.size() * sizeof(float));
+        out.write(reinterpret_cast<const char*>(codes_.data()), codes_.size());
+        return static_cast<bool>(out);
+    }
+
+    // Returns false if the file is missing, has an invalid shape or its size
+    // does not match the shape in its header
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        uint64_t header[3];
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+            return false;
+        }
+        if (header[2] == 0 || header[1] % header[2] != 0) {
+            return false;
+        }
+        uint64_t expected = sizeof(header) + header[2] * PQ_CENTROIDS * (header[1] / header[2]) * sizeof(float)
+                          + header[0] * header[2];
+        in.seekg(0, std::ios::end);
+        if (static_cast<uint64_t>(in.tellg()) != expected) {
+            return false;
+        }
+        in.seekg(sizeof(header));
+        numRows_ = header[0];
+        numCols_ = header[1];
+        numSub_ = header[2];
+        subDim_ = numCols_ / numSub_;
+        codebooks_.resize(numSub_ * PQ_CENTROIDS * subDim_);
+        codes_.resize(numRows_ * numSub_);
+        in.read(reinterpret_cast<char*>(codebooks_.data()), codebooks_.size() * sizeof(float));
+        in.read(reinterpret_cast<char*>(codes_.data()), codes_.size());
+        if (!in) {
+            return false;
+        }
+        buildNormTable();
+        return true;
+    }
+
+    void prefetch(size_t idx) const {
+        _mm_prefetch(reinterpret_cast<const char*>(&codes_[idx * numSub_]), _MM_HINT_T0);
+    }
+
+    // Reconstruct row idx into out (numCols values)
+    void decode(size_t idx, double* out) const {
+        decodeRow(idx, out, subDim_);
+    }
+
+    // Same, with the subvector width known at compile time so the per
+    // subvector SIMD conversion is fully unrolled. SubDim must match the table.
+    template <size_t SubDim>
+    void decode(size_t idx, double* out) const {
+        assert(SubDim == subDim_);
+        decodeRow(idx, out, SubDim);
+    }
+
+    // Squared L2 norm of the reconstructed row idx, computed in the code
+    // domain from the per-centroid norm table without decoding the row
+    double squaredNorm(size_t idx) const {
+        const uint8_t* code = &codes_[idx * numSub_];
+        double sum = 0.0;
+        for (size_t m = 0; m < numSub_; m++) {
+            sum += norms_[m * PQ_CENTROIDS + code[m]];
+        }
+        return sum;
+    }
+
+    size_t numRows() const { return numRows_; }
+    size_t numCols() const { return numCols_; }
+    size_t numSub() const { return numSub_; }
+
+    size_t codeBytes() const { return codes_.size(); }
+    size_t codebookBytes() const { return codebooks_.size() * sizeof(float) + norms_.size() * sizeof(double); }
+
+private:
+    inline void decodeRow(size_t idx, double* out, size_t subDim) const {
+        const uint8_t* code = &codes_[idx * numSub_];
+        for (size_t m = 0; m < numSub_; m++) {
+            const float* centroid = &codebooks_[(m * PQ_CENTROIDS + code[m]) * subDim];
+            double* dest = out + m * subDim;
+            size_t j = 0;
+#if defined(__AVX__)
+            for (; j + 4 <= subDim; j += 4) {
+                _mm256_storeu_pd(dest + j, _mm256_cvtps_pd(_mm_loadu_ps(centroid + j)));
+            }
+#endif
+            for (; j < subDim; j++) {
+                dest[j] = centroid[j];
+            }
+        }
+    }
+
+    template <typename Fn>
+    static void parallelFor(size_t n, size_t numThreads, Fn fn) {
+        numThreads = std::max<size_t>(1, std::min(numThreads, n));
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numThreads; t++) {
+            threads.push_back(std::thread(fn, n * t / numThreads, n * (t + 1) / numThreads));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    size_t nearestCentroid(const double* x, size_t m) const {
+        const float* centroids = &codebooks_[m * PQ_CENTROIDS * subDim_];
+        size_t best = 0;
+        double best_dist = std::numeric_limits<double>::max();
+        for (size_t c = 0; c < PQ_CENTROIDS; c++) {
+            double dist = 0.0;
+            for (size_t j = 0; j < subDim_; j++) {
+                double d = x[j] - centroids[c * subDim_ + j];
+                dist += d * d;
+            }
+            if (dist < best_dist) {
+                best_dist = dist;
+                best = c;
+            }
+        }
+        return best;
+    }
+
+    // Lloyd's k-means over subspace m of the sampled rows
+    void trainSubspace(const std::vector<std::vector<double>>& matrix, const std::vector<size_t>& sample,
+                       size_t m, size_t iterations, unsigned seed) {
+        float* centroids = &codebooks_[m * PQ_CENTROIDS * subDim_];
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<size_t> pick(0, sample.size() - 1);
+        for (size_t c = 0; c < PQ_CENTROIDS; c++) {
+            const double* x = &matrix[sample[pick(gen)]][m * subDim_];
+            for (size_t j = 0; j < subDim_; j++) {
+                centroids[c * subDim_ + j] = static_cast<float>(x[j]);
+            }
+        }
+
+        std::vector<double> sums(PQ_CENTROIDS * subDim_);
+        std::vector<size_t> counts(PQ_CENTROIDS);
+        for (size_t iter = 0; iter < iterations; iter++) {
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(counts.begin(), counts.end(), 0);
+            for (size_t s = 0; s < sample.size(); s++) {
+                const double* x = &matrix[sample[s]][m * subDim_];
+                size_t c = nearestCentroid(x, m);
+                counts[c]++;
+                for (size_t j = 0; j < subDim_; j++) {
+                    sums[c * subDim_ + j] += x[j];
+                }
+            }
+            for (size_t c = 0; c < PQ_CENTROIDS; c++) {
+                // Re-seed empty clusters with a random sample point
+                const double* x = counts[c] > 0 ? &sums[c * subDim_] : &matrix[sample[pick(gen)]][m * subDim_];
+                double scale = counts[c] > 0 ? 1.0 / counts[c] : 1.0;
+                for (size_t j = 0; j < subDim_; j++) {
+                    centroids[c * subDim_ + j] = static_cast<float>(x[j] * scale);
+                }
+            }
+        }
+    }
+
+    void buildNormTable() {
+        norms_.assign(numSub_ * PQ_CENTROIDS, 0.0);
+        for (size_t m = 0; m < numSub_; m++) {
+            for (size_t c = 0; c < PQ_CENTROIDS; c++) {
+                const float* centroid = &codebooks_[(m * PQ_CENTROIDS + c) * subDim_];
+                for (size_t j = 0; j < subDim_; j++) {
+                    norms_[m * PQ_CENTROIDS + c] += static_cast<double>(centroid[j]) * centroid[j];
+                }
+            }
+        }
+    }
+
+    size_t numRows_;
+    size_t numCols_;
+    size_t numSub_;
+    size_t subDim_;
+    std::vector<float> codebooks_; // [numSub][PQ_CENTROIDS][subDim]
+    std::vector<uint8_t> codes_;   // [numRows][numSub]
+    std::vector<double> norms_;    // [numSub][PQ_CENTROIDS] squared centroid norms
+};
+
+#endif // PQ_TABLE_HPP
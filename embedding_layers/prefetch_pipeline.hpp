@@ -0,0 +1,151 @@
+#ifndef PREFETCH_PIPELINE_HPP
+#define PREFETCH_PIPELINE_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <x86intrin.h> // For _mm_prefetch
+
+// Policy-based lookup pipeline shared by the embedding layer benchmarks.
+// A strategy is a combination of
+//   Predictor - which row to prefetch while row i is being processed
+//   Prefetch  - how that row is brought into the cache
+//   Reduce    - what is computed from each accessed row
+// plus the element type T and row width Dim. Everything known at compile
+// time (Dim, hint, fixed distance) is a template parameter so each strategy
+// compiles to the same straight loop a hand-written kernel would.
+
+const size_t NO_PREDICTION = SIZE_MAX;
+
+// ---- Reduce policies: per-row value added to the running result ----
+
+// Average of squared values in a row
+struct MeanSquareReduce {
+    template <typename T, size_t Dim>
+    static double apply(const T* row) {
+        double row_sum = 0.0;
+        for (size_t j = 0; j < Dim; j++) {
+            row_sum += row[j] * row[j];
+        }
+        return row_sum / Dim;
+    }
+};
+
+// Dot product of the row with itself computed twice, averaged over Dim
+// (the synthetic compute load of the prefetch-ahead benchmarks)
+struct DoubleDotReduce {
+    template <typename T, size_t Dim>
+    static double apply(const T* row) {
+        double row_sum = 0.0;
+        for (size_t n = 0; n < 2; n++) {
+            double dot_product = 0.0;
+            for (size_t j = 0; j < Dim; j++) {
+                dot_product += row[j] * row[j];
+            }
+            row_sum += dot_product;
+        }
+        return row_sum / Dim;
+    }
+};
+
+// ---- Prefetch policies ----
+
+struct NoPrefetch {
+    template <typename T, size_t Dim>
+    static void issue(const T*) {}
+};
+
+// Prefetch the first cache line of the row
+//_MM_HINT_T0: Prefetch into all levels of the cache.
+//_MM_HINT_T1: Prefetch into L2 cache and higher.
+//_MM_HINT_T2: Prefetch into L3 cache and higher.
+//_MM_HINT_NTA: Prefetch non-temporal, minimizing cache pollution.
+template <int Hint = _MM_HINT_T0>
+struct FirstLinePrefetch {
+    template <typename T, size_t Dim>
+    static void issue(const T* row) {
+        _mm_prefetch(reinterpret_cast<const char*>(row), static_cast<_mm_hint>(Hint));
+    }
+};
+
+// Prefetch every cache line of the row
+template <int Hint = _MM_HINT_T0>
+struct FullRowPrefetch {
+    template <typename T, size_t Dim>
+    static void issue(const T* row) {
+        const char* base = reinterpret_cast<const char*>(row);
+        for (size_t offset = 0; offset < Dim * sizeof(T); offset += 64) {
+            _mm_prefetch(base + offset, static_cast<_mm_hint>(Hint));
+        }
+    }
+};
+
+// ---- Predictor policies ----
+// end(n) is the number of leading positions that predict at all; the
+// pipeline runs the remaining positions in a tail loop without prefetching.
+// predict(pattern, i) returns the row to prefetch at position i, or
+// NO_PREDICTION.
+
+struct NoPredictor {
+    size_t end(size_t) const { return 0; }
+    size_t predict(const std::vector<size_t>&, size_t) { return NO_PREDICTION; }
+};
+
+// Row Distance positions ahead in the access pattern, distance fixed at compile time
+template <size_t Distance>
+struct FixedDistancePredictor {
+    size_t end(size_t n) const { return n > Distance ? n - Distance : 0; }
+    size_t predict(const std::vector<size_t>& pattern, size_t i) { return pattern[i + Distance]; }
+};
+
+// Same with the distance chosen at run time (e.g. a distance sweep)
+struct RuntimeDistancePredictor {
+    size_t distance;
+
+    explicit RuntimeDistancePredictor(size_t d) : distance(d) {}
+    size_t end(size_t n) const { return n > distance ? n - distance : 0; }
+    size_t predict(const std::vector<size_t>& pattern, size_t i) { return pattern[i + distance]; }
+};
+
+// Most likely next word given the current one
+struct NextWordPredictor {
+    const std::unordered_map<size_t, size_t>& mostLikelyNext;
+
+    explicit NextWordPredictor(const std::unordered_map<size_t, size_t>& m) : mostLikelyNext(m) {}
+    size_t end(size_t n) const { return n > 0 ? n - 1 : 0; }
+    size_t predict(const std::vector<size_t>& pattern, size_t i) {
+        auto it = mostLikelyNext.find(pattern[i]);
+        return it != mostLikelyNext.end() ? it->second : NO_PREDICTION;
+    }
+};
+
+// ---- Pipeline ----
+
+// Run Reduce over every row of accessPattern, prefetching the rows chosen by
+// predictor with the Prefetch policy, and return the mean of the row values
+template <typename T, size_t Dim, typename Reduce, typename Prefetch, typename Predictor>
+double pipelineAccess(const std::vector<std::vector<T>>& matrix,
+                      const std::vector<size_t>& accessPattern,
+                      Predictor predictor) {
+    double result = 0.0;
+    const size_t n = accessPattern.size();
+    const size_t prefetch_end = predictor.end(n);
+
+    size_t i = 0;
+    for (; i < prefetch_end; i++) {
+        size_t next = predictor.predict(accessPattern, i);
+        if (next < matrix.size()) {
+            Prefetch::template issue<T, Dim>(&matrix[next][0]);
+        }
+        result += Reduce::template apply<T, Dim>(&matrix[accessPattern[i]][0]);
+    }
+
+    // Handle remaining elements without prefetching
+    for (; i < n; i++) {
+        result += Reduce::template apply<T, Dim>(&matrix[accessPattern[i]][0]);
+    }
+
+    return result / n;
+}
+
+#endif // PREFETCH_PIPELINE_HPP
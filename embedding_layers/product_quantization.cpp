@@ -0,0 +1,180 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <x86intrin.h> // For _mm_prefetch
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <numeric> // For std::accumulate
+#include <cmath> // For std::sqrt
+#include <thread> // For std::thread::hardware_concurrency
+#include "pq_table.hpp" // Product-quantized table
+#include "prefetch_pipeline.hpp" // Policy-based lookup kernels
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.840B.300d.txt";
+const std::string PQ_PATH = "data/glove.840B.300d.pq";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 300;        // GloVe embedding dimension
+const size_t PQ_SUBVECTORS = 50;    // Subvectors per row (bytes per code)
+const size_t PQ_TRAIN_ROWS = 32768; // Rows sampled to train the codebooks
+const size_t PQ_ITERATIONS = 10;    // k-means iterations per codebook
+const size_t PREFETCH_AHEAD = 11;   // Prefetch ahead distance
+const size_t NUM_RUNS = 10;         // Number of times to run each test
+
+static_assert(NUM_COLS % PQ_SUBVECTORS == 0, "PQ_SUBVECTORS must divide NUM_COLS");
+
+// Function to perform row operations without prefetching
+double regularAccess(const std::vector<std::vector<double>>& matrix,
+                    const std::vector<size_t>& accessPattern) {
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, NoPrefetch>(matrix, accessPattern, NoPredictor());
+}
+
+// Function to perform row operations with prefetching
+double prefetchedAccess(const std::vector<std::vector<double>>& matrix,
+                       const std::vector<size_t>& accessPattern) {
+    return pipelineAccess<double, NUM_COLS, MeanSquareReduce, FirstLinePrefetch<_MM_HINT_T0> >(
+        matrix, accessPattern, FixedDistancePredictor<PREFETCH_AHEAD>());
+}
+
+// Function to perform row operations on rows reconstructed from PQ codes
+double pqDecodeAccess(const PQTable& table, const std::vector<size_t>& accessPattern) {
+    double result = 0.0;
+    double row[NUM_COLS];
+
+    for (size_t i = 0; i < accessPattern.size(); i++) {
+        if (i + PREFETCH_AHEAD < accessPattern.size()) {
+            table.prefetch(accessPattern[i + PREFETCH_AHEAD]);
+        }
+        table.decode<NUM_COLS / PQ_SUBVECTORS>(accessPattern[i], row);
+        result += MeanSquareReduce::apply<double, NUM_COLS>(row);
+    }
+    return result / accessPattern.size();
+}
+
+// Function to perform row operations directly in the code domain
+double pqCodeAccess(const PQTable& table, const std::vector<size_t>& accessPattern) {
+    double result = 0.0;
+
+    for (size_t i = 0; i < accessPattern.size(); i++) {
+        if (i + PREFETCH_AHEAD < accessPattern.size()) {
+            table.prefetch(accessPattern[i + PREFETCH_AHEAD]);
+        }
+        result += table.squaredNorm(accessPattern[i]) / NUM_COLS;
+    }
+    return result / accessPattern.size();
+}
+
+// Time NUM_RUNS calls of fn and return the mean time in ms
+template <typename Fn>
+double timeRuns(Fn fn) {
+    std::vector<double> times;
+    for (size_t run = 0; run < NUM_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6);
+    }
+    return std::accumulate(times.begin(), times.end(), 0.0) / NUM_RUNS;
+}
+
+int main() {
+    // Load GloVe embeddings
+    std::cout << "Loading GloVe embeddings..." << std::endl;
+    std::unordered_map<std::string, size_t> word_to_idx;
+    std::vector<std::vector<double>> matrix;
+
+    std::ifstream glove_file(GLOVE_PATH);
+    std::string line;
+    size_t idx = 0;
+
+    while (std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        std::vector<double> embedding(NUM_COLS);
+        for (size_t i = 0; i < NUM_COLS; i++) {
+            iss >> embedding[i];
+        }
+
+        word_to_idx[word] = idx;
+        matrix.push_back(embedding);
+        idx++;
+    }
+
+    // Load input words and create access pattern
+    std::cout << "Loading input words..." << std::endl;
+    std::vector<size_t> accessPattern;
+    std::ifstream input_file(INPUT_PATH);
+    std::string word;
+
+    while (input_file >> word) {
+        if (word_to_idx.find(word) != word_to_idx.end()) {
+            accessPattern.push_back(word_to_idx[word]);
+        }
+    }
+
+    if (accessPattern.empty()) {
+        std::cerr << "No valid words found in input file!" << std::endl;
+        return 1;
+    }
+
+    // Build the codebooks on first use and reuse them afterwards
+    PQTable table;
+    if (!table.load(PQ_PATH) || table.numRows() != matrix.size() || table.numCols() != NUM_COLS
+        || table.numSub() != PQ_SUBVECTORS) {
+        std::cout << "Training " << PQ_SUBVECTORS << " codebooks of " << PQ_CENTROIDS
+                  << " centroids and encoding " << matrix.size() << " rows..." << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        table.build(matrix, PQ_SUBVECTORS, PQ_TRAIN_ROWS, PQ_ITERATIONS,
+                    std::max(1u, std::thread::hardware_concurrency()), 573);
+        auto end = std::chrono::steady_clock::now();
+        std::cout << "Built in " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1e3
+                  << " s" << std::endl;
+        table.save(PQ_PATH);
+    }
+
+    // Reconstruction error against the double table
+    double err_sum = 0.0, norm_sum = 0.0;
+    double row[NUM_COLS];
+    for (size_t r = 0; r < matrix.size(); r++) {
+        table.decode(r, row);
+        for (size_t j = 0; j < NUM_COLS; j++) {
+            double d = matrix[r][j] - row[j];
+            err_sum += d * d;
+            norm_sum += matrix[r][j] * matrix[r][j];
+        }
+    }
+
+    size_t double_bytes = matrix.size() * NUM_COLS * sizeof(double);
+    size_t pq_bytes = table.codeBytes() + table.codebookBytes();
+    std::cout << "\nDouble table: " << double_bytes / 1048576.0 << " MB" << std::endl;
+    std::cout << "PQ table: " << pq_bytes / 1048576.0 << " MB (codes " << table.codeBytes() / 1048576.0
+              << " MB, codebooks " << table.codebookBytes() / 1024.0 << " KB), "
+              << static_cast<double>(double_bytes) / pq_bytes << "x smaller" << std::endl;
+    std::cout << "Relative reconstruction error (squared L2): " << err_sum / norm_sum << std::endl;
+
+    double result1 = 0.0, result2 = 0.0, result3 = 0.0, result4 = 0.0;
+    double regular = timeRuns([&] { result1 = regularAccess(matrix, accessPattern); });
+    double prefetched = timeRuns([&] { result2 = prefetchedAccess(matrix, accessPattern); });
+    double decoded = timeRuns([&] { result3 = pqDecodeAccess(table, accessPattern); });
+    double code = timeRuns([&] { result4 = pqCodeAccess(table, accessPattern); });
+
+    const double lookups = static_cast<double>(accessPattern.size());
+    std::cout << "\nRegular access: " << regular << " ms, " << lookups / (regular / 1e3) << " lookups/s" << std::endl;
+    std::cout << "Prefetched access: " << prefetched << " ms, " << lookups / (prefetched / 1e3) << " lookups/s"
+              << ", speedup " << regular / prefetched << "x" << std::endl;
+    std::cout << "PQ decode access: " << decoded << " ms, " << lookups / (decoded / 1e3) << " lookups/s"
+              << ", speedup " << regular / decoded << "x" << std::endl;
+    std::cout << "PQ code-domain access: " << code << " ms, " << lookups / (code / 1e3) << " lookups/s"
+              << ", speedup " << regular / code << "x" << std::endl;
+
+    std::cout << "\nPrefetched results match: " << (std::abs(result1 - result2) < 1e-10) << std::endl;
+    std::cout << "PQ decode relative result error: " << std::abs(result3 - result1) / result1 << std::endl;
+    std::cout << "PQ code-domain relative result error: " << std::abs(result4 - result1) / result1 << std::endl;
+
+    return 0;
+}
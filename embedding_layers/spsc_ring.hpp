@@ -0,0 +1,134 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <x86intrin.h> // For _mm_pause
+
+// Lock-free single-producer single-consumer ring buffer. Positions are
+// absolute sequence numbers (they never wrap, the slot is seq & mask), so the
+// consumer can look at entries the producer has already published but it has
+// not yet popped, e.g. to prefetch the rows they will need.
+// Each side caches the other side's position and only reloads it when the
+// cached value says the ring is full (producer) or empty (consumer), which
+// keeps the shared cache lines from bouncing on every element.
+template <typename T>
+class SpscRing {
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity)
+        : writePos_(0), closed_(false), cachedRead_(0), readPos_(0), cachedWrite_(0) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    // ---- Producer side ----
+
+    bool tryPush(const T& value) {
+        uint64_t pos = writePos_.load(std::memory_order_relaxed);
+        if (pos - cachedRead_ > mask_) {
+            cachedRead_ = readPos_.load(std::memory_order_acquire);
+            if (pos - cachedRead_ > mask_) {
+                return false;
+            }
+        }
+        slots_[pos & mask_] = value;
+        writePos_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Spin (then yield, so a single core can run the consumer) until there is room
+    void push(const T& value) {
+        for (size_t spins = 0; !tryPush(value); spins++) {
+            backoff(spins);
+        }
+    }
+
+    // Spin until the next push is guaranteed to succeed, e.g. to timestamp an
+    // element only once it can be published
+    void waitForSpace() {
+        uint64_t pos = writePos_.load(std::memory_order_relaxed);
+        for (size_t spins = 0; pos - cachedRead_ > mask_; spins++) {
+            cachedRead_ = readPos_.load(std::memory_order_acquire);
+            if (pos - cachedRead_ > mask_) {
+                backoff(spins);
+            }
+        }
+    }
+
+    // No more elements will be pushed
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    // ---- Consumer side ----
+
+    // First position not yet popped
+    uint64_t readPos() const { return readPos_.load(std::memory_order_relaxed); }
+
+    // One past the last published position. Reloads the producer position
+    // only if the cached one has already been consumed up to limit.
+    uint64_t writePos(uint64_t limit) {
+        if (cachedWrite_ < limit) {
+            cachedWrite_ = writePos_.load(std::memory_order_acquire);
+        }
+        return cachedWrite_;
+    }
+
+    // Published element at position seq, readPos() <= seq < writePos()
+    const T& at(uint64_t seq) const { return slots_[seq & mask_]; }
+
+    bool tryPop(T& value) {
+        uint64_t pos = readPos_.load(std::memory_order_relaxed);
+        if (pos >= writePos(pos + 1)) {
+            return false;
+        }
+        value = slots_[pos & mask_];
+        readPos_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Wait for the next element. Returns false once the ring is closed and drained.
+    bool pop(T& value) {
+        for (size_t spins = 0; !tryPop(value); spins++) {
+            if (closed_.load(std::memory_order_acquire)) {
+                // Elements pushed before close() are visible after the acquire
+                return tryPop(value);
+            }
+            backoff(spins);
+        }
+        return true;
+    }
+
+    size_t capacity() const { return slots_.size(); }
+    size_t bytes() const { return slots_.size() * sizeof(T); }
+
+private:
+    static void backoff(size_t spins) {
+        if (spins < 64) {
+            _mm_pause();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    std::vector<T> slots_;
+    uint64_t mask_;
+
+    // Producer-owned line
+    alignas(64) std::atomic<uint64_t> writePos_;
+    std::atomic<bool> closed_;
+    uint64_t cachedRead_;
+
+    // Consumer-owned line
+    alignas(64) std::atomic<uint64_t> readPos_;
+    uint64_t cachedWrite_;
+
+    char pad_[64 - sizeof(std::atomic<uint64_t>) - sizeof(uint64_t)];
+};
+
+#endif // SPSC_RING_HPP
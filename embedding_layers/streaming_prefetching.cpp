@@ -0,0 +1,251 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <x86intrin.h> // For _mm_prefetch
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <cmath> // For std::abs
+#include <cstdint>
+#include <cstdlib> // For std::strtoul
+#include <thread>
+#include <algorithm> // For std::min
+#include "spsc_ring.hpp" // Lock-free token ring between reader and lookup threads
+#include "prefetch_pipeline.hpp" // Reduce and Prefetch policies
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 25;         // GloVe embedding dimension
+const size_t RING_CAPACITY = 4096;  // Tokens buffered between reader and lookup thread
+const size_t STREAM_PASSES = 20;    // Times the input file is streamed per run
+const size_t PREFETCH_AHEADS[] = {0, 4, 11, 32}; // Lookahead limits tested (0 = no prefetch)
+
+// One token in flight: the row to look up and when the reader published it.
+// The timestamp is taken once the ring has room, so queue wait does not
+// include the reader's own wait on a full ring.
+struct StreamToken {
+    size_t idx;
+    int64_t enqueue_ns;
+};
+
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Fixed-size log-linear latency histogram: 16 linear sub-buckets per power of
+// two, so percentiles are within 1/16 of the true value and memory does not
+// grow with the number of tokens.
+class LatencyHistogram {
+public:
+    static const size_t SUB_BUCKETS = 16;
+    static const size_t NUM_BUCKETS = 64 * SUB_BUCKETS;
+
+    LatencyHistogram() : counts_(NUM_BUCKETS, 0), total_(0), max_(0) {}
+
+    void record(int64_t ns) {
+        uint64_t v = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        counts_[bucket(v)]++;
+        total_++;
+        max_ = std::max(max_, v);
+    }
+
+    // Lower bound of the bucket holding the p-th percentile (0 < p <= 100)
+    uint64_t percentile(double p) const {
+        uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * total_));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < NUM_BUCKETS; b++) {
+            seen += counts_[b];
+            if (seen >= rank && counts_[b] > 0) {
+                return lowerBound(b);
+            }
+        }
+        return max_;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+    size_t bytes() const { return counts_.size() * sizeof(uint64_t); }
+
+private:
+    static size_t bucket(uint64_t v) {
+        if (v < SUB_BUCKETS) {
+            return v;
+        }
+        size_t exp = 63 - __builtin_clzll(v); // >= 4
+        size_t sub = (v >> (exp - 4)) & (SUB_BUCKETS - 1);
+        return (exp - 3) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t lowerBound(size_t b) {
+        if (b < SUB_BUCKETS) {
+            return b;
+        }
+        size_t exp = b / SUB_BUCKETS + 3;
+        return (SUB_BUCKETS + b % SUB_BUCKETS) << (exp - 4);
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    uint64_t max_;
+};
+
+// Tokenize the input into the ring, word by word, so nothing but the ring and
+// the vocabulary is held in memory. path "-" streams standard input once.
+// Stops early if the file cannot be opened.
+void readerThread(const std::string& path, size_t passes,
+                  const std::unordered_map<std::string, size_t>& word_to_idx,
+                  SpscRing<StreamToken>& ring) {
+    std::string word;
+    for (size_t pass = 0; pass < passes; pass++) {
+        std::ifstream input_file;
+        std::istream* in = &std::cin;
+        if (path != "-") {
+            input_file.open(path);
+            if (!input_file.is_open()) {
+                break;
+            }
+            in = &input_file;
+        }
+        while (*in >> word) {
+            auto it = word_to_idx.find(word);
+            if (it != word_to_idx.end()) {
+                ring.waitForSpace();
+                StreamToken token = {it->second, nowNs()};
+                ring.push(token);
+            }
+        }
+    }
+    ring.close();
+}
+
+struct StreamStats {
+    size_t tokens;
+    double lookahead_sum; // Sum over tokens of rows already prefetched ahead of it
+};
+
+// Function to perform row operations on the token stream, prefetching up to
+// prefetchAhead rows that the reader has already published to the ring.
+// Records each token's queue wait (published to popped) and service time
+// (popped to row operation done) separately: the queue wait is set by the
+// ring occupancy, the service time is where prefetching shows.
+double streamAccess(const std::vector<std::vector<double>>& matrix,
+                    SpscRing<StreamToken>& ring, size_t prefetchAhead,
+                    LatencyHistogram& queueWait, LatencyHistogram& service,
+                    StreamStats& stats) {
+    double result = 0.0;
+    uint64_t prefetched = 0; // One past the last position prefetched
+    StreamToken token;
+
+    while (true) {
+        if (prefetchAhead > 0) {
+            uint64_t next = ring.readPos() + 1;
+            uint64_t end = std::min(ring.writePos(next + prefetchAhead), next + prefetchAhead);
+            prefetched = std::max(prefetched, next);
+            for (; prefetched < end; prefetched++) {
+                FirstLinePrefetch<_MM_HINT_T0>::issue<double, NUM_COLS>(&matrix[ring.at(prefetched).idx][0]);
+            }
+            stats.lookahead_sum += end > next ? end - next : 0;
+        }
+        if (!ring.pop(token)) {
+            break;
+        }
+        int64_t popped = nowNs();
+        result += MeanSquareReduce::apply<double, NUM_COLS>(&matrix[token.idx][0]);
+        service.record(nowNs() - popped);
+        queueWait.record(popped - token.enqueue_ns);
+        stats.tokens++;
+    }
+    return stats.tokens > 0 ? result / stats.tokens : 0.0;
+}
+
+void printLatency(const char* name, const LatencyHistogram& latency) {
+    std::cout << "  " << name << " (ns) p50 " << latency.percentile(50) << ", p90 " << latency.percentile(90)
+              << ", p99 " << latency.percentile(99) << ", p99.9 " << latency.percentile(99.9)
+              << ", max " << latency.max() << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // Optional: input path ("-" for standard input) and number of passes
+    std::string input_path = argc > 1 ? argv[1] : INPUT_PATH;
+    size_t passes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : STREAM_PASSES;
+    if (input_path == "-") {
+        passes = 1;
+    }
+
+    // Load GloVe embeddings
+    std::cout << "Loading GloVe embeddings..." << std::endl;
+    std::unordered_map<std::string, size_t> word_to_idx;
+    std::vector<std::vector<double>> matrix;
+
+    std::ifstream glove_file(GLOVE_PATH);
+    std::string line;
+    size_t idx = 0;
+
+    while (std::getline(glove_file, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+
+        std::vector<double> embedding(NUM_COLS);
+        for (size_t i = 0; i < NUM_COLS; i++) {
+            iss >> embedding[i];
+        }
+
+        word_to_idx[word] = idx;
+        matrix.push_back(embedding);
+        idx++;
+    }
+
+    if (input_path != "-" && !std::ifstream(input_path).is_open()) {
+        std::cerr << "Cannot open input file " << input_path << std::endl;
+        return 1;
+    }
+
+    // Standard input can only be streamed once, so test a single lookahead
+    std::vector<size_t> aheads(PREFETCH_AHEADS, PREFETCH_AHEADS + sizeof(PREFETCH_AHEADS) / sizeof(PREFETCH_AHEADS[0]));
+    if (input_path == "-") {
+        aheads.assign(1, 11);
+    }
+
+    std::cout << "Streaming " << (input_path == "-" ? "standard input" : input_path)
+              << " " << passes << " time(s) through a " << RING_CAPACITY << "-token ring..." << std::endl;
+
+    double result0 = 0.0;
+    for (size_t a = 0; a < aheads.size(); a++) {
+        SpscRing<StreamToken> ring(RING_CAPACITY);
+        LatencyHistogram queueWait, service;
+        StreamStats stats = {0, 0.0};
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread reader(readerThread, std::cref(input_path), passes, std::cref(word_to_idx), std::ref(ring));
+        double result = streamAccess(matrix, ring, aheads[a], queueWait, service, stats);
+        reader.join();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e9;
+
+        if (stats.tokens == 0) {
+            std::cerr << "No valid words found in input file!" << std::endl;
+            return 1;
+        }
+        if (a == 0) {
+            result0 = result;
+        }
+
+        std::cout << "\nPREFETCH_AHEAD = " << aheads[a] << std::endl;
+        std::cout << "  Tokens: " << stats.tokens << ", " << stats.tokens / seconds << " tokens/s end to end" << std::endl;
+        if (aheads[a] > 0) {
+            std::cout << "  Mean rows prefetched ahead: " << stats.lookahead_sum / std::max<size_t>(1, stats.tokens) << std::endl;
+        }
+        printLatency("Service time", service);
+        printLatency("Queue wait", queueWait);
+        std::cout << "  Streaming memory: ring " << ring.bytes() / 1024.0 << " KiB, histograms "
+                  << (service.bytes() + queueWait.bytes()) / 1024.0 << " KiB" << std::endl;
+        std::cout << "  Results match: " << (std::abs(result - result0) < 1e-10) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <deque>
+#include <algorithm> // For std::min
+#include <cmath> // For std::abs
+#include <cstdint>
+#include <fcntl.h> // For posix_fadvise
+#include "ngram.hpp" // Include the n-gram model header
+#include "glove_binary.hpp" // Binary GloVe conversion
+#include "prefetch_pipeline.hpp" // Reduce policies
+#include "tiered_table.hpp" // Hot rows in RAM, cold rows on disk
+
+// Global constants
+const std::string GLOVE_PATH = "data/glove.840B.300d.txt";
+const std::string BINARY_PATH = "data/glove.840B.300d.bin";
+const std::string VOCAB_PATH = "data/glove.840B.300d.vocab";
+const std::string INPUT_PATH = "data/input.txt";
+const size_t NUM_COLS = 300;              // GloVe embedding dimension
+const int NGRAM_ORDER = 3;                // Order of the n-gram model
+const size_t MEMORY_BUDGET_MB = 256;      // Upper bound on hot tier plus cold slots
+const double HOT_FRACTION = 0.10;         // Hot rows as a fraction of the distinct rows accessed
+const size_t CACHE_SLOTS = 4096;          // Cold row slots
+const size_t DISK_PREFETCH_AHEAD = 64;    // Lookahead of the known-next disk prefetch
+const size_t PREDICT_DEPTH = 16;          // Predicted words followed ahead of the current one
+const size_t PREDICTIONS_PER_TOKEN = 2;   // Most predictions a single token may add to the chain
+const size_t QUEUE_DEPTH = 128;           // Maximum cold reads in flight
+const size_t IO_THREADS = 8;              // I/O threads of the pread backend
+
+// How the cold tier is prefetched
+enum DiskPrefetch {
+    DISK_NONE,       // Every cold row is read synchronously on demand
+    DISK_KNOWN_NEXT, // Rows DISK_PREFETCH_AHEAD tokens ahead are known
+    DISK_NEXT_WORD,  // Follow the most likely next word PREDICT_DEPTH steps
+    DISK_NGRAM       // Follow n-gram predictions PREDICT_DEPTH steps
+};
+
+const char* diskPrefetchName(DiskPrefetch mode) {
+    switch (mode) {
+        case DISK_NONE: return "no prefetch";
+        case DISK_KNOWN_NEXT: return "known-next";
+        case DISK_NEXT_WORD: return "next-word";
+        case DISK_NGRAM: return "n-gram";
+    }
+    return "unknown";
+}
+
+// Most likely next word of every n-gram prefix, precomputed from the models
+// like the most likely next word mapping, with the prefix (at most two row
+// indices below 2^32) packed into one integer key. A prediction is then at
+// most NGRAM_ORDER integer hash lookups, where predictNextWord allocates a
+// prefix vector per backoff step and scans every continuation of the matched
+// prefix (the whole vocabulary when it backs off to unigrams).
+class NGramArgmax {
+public:
+    static_assert(NGRAM_ORDER <= 3, "prefixes are packed into 64-bit keys");
+
+    explicit NGramArgmax(const std::vector<NGram>& models) : best_(models.size()) {
+        for (size_t k = 0; k < models.size(); k++) {
+            for (const auto& pair : models[k]) {
+                // Same choice, ties included, as predictNextWord
+                best_[k][key(pair.first.begin(), pair.first.end())] =
+                    std::max_element(pair.second.begin(), pair.second.end(),
+                        [](const std::pair<const size_t, int>& a, const std::pair<const size_t, int>& b) {
+                            return a.second < b.second;
+                        })->first;
+            }
+        }
+    }
+
+    // Same prediction as predictNextWord(models, context)
+    size_t predict(const std::vector<size_t>& context) const {
+        for (size_t k = best_.size(); k > 0; k--) {
+            if (context.size() < k - 1) {
+                continue;
+            }
+            auto it = best_[k - 1].find(key(context.end() - (k - 1), context.end()));
+            if (it != best_[k - 1].end()) {
+                return it->second;
+            }
+        }
+        return 0;
+    }
+
+private:
+    template <typename It>
+    static uint64_t key(It begin, It end) {
+        uint64_t packed = 0;
+        for (; begin != end; ++begin) {
+            packed = (packed << 32) | *begin;
+        }
+        return packed;
+    }
+
+    std::vector<std::unordered_map<uint64_t, size_t>> best_;
+};
+
+// Function to perform row operations on the tiered table, prefetching cold
+// rows from disk far ahead of their use. The predictors keep a chain of up
+// to PREDICT_DEPTH predicted tokens; while the actual tokens follow the chain
+// only its tail is extended, so each token costs one prediction and the
+// prefetches already issued for the chain stay useful. A misprediction
+// restarts the chain, which then regrows by at most PREDICTIONS_PER_TOKEN
+// per token so the predictor never dominates the lookup time.
+double tieredAccess(TieredEmbeddingTable& table,
+                    const std::vector<size_t>& accessPattern,
+                    DiskPrefetch mode,
+                    const std::unordered_map<size_t, size_t>& mostLikelyNext,
+                    const NGramArgmax& ngramArgmax) {
+    double result = 0.0;
+    std::vector<size_t> context;
+    std::deque<size_t> chain;          // Predicted tokens following the current one
+    std::vector<size_t> chain_context; // Context at the end of the chain
+
+    for (size_t i = 0; i < accessPattern.size(); i++) {
+        size_t current = accessPattern[i];
+
+        if (mode == DISK_KNOWN_NEXT) {
+            if (i + DISK_PREFETCH_AHEAD < accessPattern.size()) {
+                table.prefetch(accessPattern[i + DISK_PREFETCH_AHEAD]);
+            }
+        } else if (mode != DISK_NONE) {
+            if (context.size() >= NGRAM_ORDER - 1) {
+                context.erase(context.begin());
+            }
+            context.push_back(current);
+
+            if (!chain.empty() && chain.front() == current) {
+                chain.pop_front();
+            } else {
+                // Misprediction: restart the chain from the actual context
+                chain.clear();
+                chain_context = context;
+            }
+
+            for (size_t p = 0; p < PREDICTIONS_PER_TOKEN && chain.size() < PREDICT_DEPTH; p++) {
+                size_t predicted;
+                if (mode == DISK_NEXT_WORD) {
+                    auto it = mostLikelyNext.find(chain_context.back());
+                    if (it == mostLikelyNext.end()) {
+                        break;
+                    }
+                    predicted = it->second;
+                } else {
+                    predicted = ngramArgmax.predict(chain_context);
+                }
+                table.prefetch(predicted);
+                chain.push_back(predicted);
+                if (chain_context.size() >= NGRAM_ORDER - 1) {
+                    chain_context.erase(chain_context.begin());
+                }
+                chain_context.push_back(predicted);
+            }
+        }
+
+        result += MeanSquareReduce::apply<double, NUM_COLS>(table.row(current));
+    }
+    return result / accessPattern.size();
+}
+
+// Evict the binary table from the page cache so every run starts cold
+void dropPageCache(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+int main() {
+    // Convert the GloVe text file to the binary layout on first use, or
+    // again if an earlier conversion did not complete
+    const size_t row_bytes = NUM_COLS * sizeof(double);
+    std::unordered_map<std::string, size_t> word_to_idx;
+    size_t num_rows = loadVocab(VOCAB_PATH, BINARY_PATH, NUM_COLS, word_to_idx);
+    if (num_rows == 0) {
+        std::cout << "Converting GloVe embeddings to " << BINARY_PATH << "..." << std::endl;
+        if (convertGloveToBinary(GLOVE_PATH, BINARY_PATH, VOCAB_PATH, NUM_COLS) == 0) {
+            std::cerr << "Cannot convert " << GLOVE_PATH << std::endl;
+            return 1;
+        }
+        num_rows = loadVocab(VOCAB_PATH, BINARY_PATH, NUM_COLS, word_to_idx);
+        if (num_rows == 0) {
+            std::cerr << "Incomplete conversion in " << BINARY_PATH << std::endl;
+            return 1;
+        }
+    }
+
+    // Load input words and create access pattern
+    std::cout << "Loading input words..." << std::endl;
+    std::vector<size_t> accessPattern;
+    std::ifstream input_file(INPUT_PATH);
+    std::string word;
+
+    while (input_file >> word) {
+        auto it = word_to_idx.find(word);
+        if (it != word_to_idx.end() && it->second < num_rows) {
+            accessPattern.push_back(it->second);
+        }
+    }
+
+    if (accessPattern.empty()) {
+        std::cerr << "No valid words found in input file!" << std::endl;
+        return 1;
+    }
+
+    // Build the most likely next word mapping
+    std::cout << "Building most likely next word mapping..." << std::endl;
+    std::unordered_map<size_t, std::unordered_map<size_t, size_t>> transition_counts;
+    for (size_t i = 0; i + 1 < accessPattern.size(); i++) {
+        transition_counts[accessPattern[i]][accessPattern[i + 1]]++;
+    }
+
+    std::unordered_map<size_t, size_t> mostLikelyNext;
+    for (const auto& pair : transition_counts) {
+        size_t max_count = 0;
+        size_t likely_next = 0;
+        for (const auto& inner_pair : pair.second) {
+            if (inner_pair.second > max_count) {
+                max_count = inner_pair.second;
+                likely_next = inner_pair.first;
+            }
+        }
+        mostLikelyNext[pair.first] = likely_next;
+    }
+
+    // Build the n-gram model
+    std::cout << "Building " << NGRAM_ORDER << "-gram model..." << std::endl;
+    std::vector<NGram> ngramModels(NGRAM_ORDER);
+    buildKGramModels(ngramModels, accessPattern, NGRAM_ORDER);
+    NGramArgmax ngramArgmax(ngramModels);
+
+    // Size the hot tier as a fraction of the working set, capped by the
+    // budget. GloVe files list words by descending corpus frequency, so the
+    // hot rows are the first rows of the table: ranked independently of the
+    // trace being timed, like a table shipped with a fixed hot set.
+    std::vector<bool> accessed(num_rows, false);
+    size_t distinct = 0;
+    for (size_t idx : accessPattern) {
+        distinct += accessed[idx] ? 0 : 1;
+        accessed[idx] = true;
+    }
+
+    size_t budget = MEMORY_BUDGET_MB << 20;
+    size_t fixed_bytes = num_rows * sizeof(int32_t) + CACHE_SLOTS * TieredEmbeddingTable::slotBytes(NUM_COLS);
+    size_t budget_rows = budget > fixed_bytes ? (budget - fixed_bytes) / row_bytes : 0;
+    size_t hot_capacity = std::min(budget_rows, static_cast<size_t>(HOT_FRACTION * distinct));
+    std::vector<size_t> hotRows;
+    for (size_t r = 0; r < num_rows && hotRows.size() < hot_capacity; r++) {
+        hotRows.push_back(r);
+    }
+    size_t hot_accesses = 0;
+    for (size_t idx : accessPattern) {
+        hot_accesses += idx < hotRows.size() ? 1 : 0;
+    }
+
+    std::cout << "\nTable: " << num_rows << " rows, " << (num_rows * row_bytes >> 20) << " MB on disk" << std::endl;
+    std::cout << "Memory budget: " << MEMORY_BUDGET_MB << " MB, hot rows: " << hotRows.size()
+              << " (" << 100.0 * HOT_FRACTION << "% of " << distinct << " distinct rows accessed, "
+              << 100.0 * hot_accesses / accessPattern.size() << "% of accesses)" << std::endl;
+
+    const ColdBackend backends[] = {COLD_IO_URING, COLD_PREAD};
+    const DiskPrefetch modes[] = {DISK_NONE, DISK_KNOWN_NEXT, DISK_NEXT_WORD, DISK_NGRAM};
+    double reference = 0.0;
+    double reference_time = 0.0;
+    bool cold_measured = true;
+
+    for (ColdBackend backend : backends) {
+        for (DiskPrefetch mode : modes) {
+            dropPageCache(BINARY_PATH);
+            TieredEmbeddingTable table(BINARY_PATH, num_rows, NUM_COLS, hotRows, CACHE_SLOTS,
+                                       backend, QUEUE_DEPTH, IO_THREADS);
+            if (backend == COLD_IO_URING && mode == DISK_NONE) {
+                std::cout << "Resident: " << (table.residentBytes() >> 20) << " MB"
+                          << ", O_DIRECT: " << table.directIO() << std::endl;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            double result = tieredAccess(table, accessPattern, mode, mostLikelyNext, ngramArgmax);
+            auto end = std::chrono::steady_clock::now();
+            double duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+
+            if (backend == COLD_IO_URING && mode == DISK_NONE) {
+                reference = result;
+                reference_time = duration;
+            }
+
+            const TieredEmbeddingTable::Stats& stats = table.stats();
+            size_t cold = stats.coldHits + stats.coldWaits + stats.coldMisses;
+            std::cout << "\n" << (table.backend() == COLD_IO_URING ? "io_uring" : "pread pool")
+                      << ", " << diskPrefetchName(mode) << ": " << duration << " ms"
+                      << ", " << accessPattern.size() / (duration / 1e3) << " lookups/s"
+                      << ", speedup " << reference_time / duration << "x" << std::endl;
+            std::cout << "  cold lookups: " << cold
+                      << " (ready " << stats.coldHits << ", waited " << stats.coldWaits
+                      << ", sync " << stats.coldMisses << ")"
+                      << ", prefetches issued " << stats.prefetches << ", dropped " << stats.dropped << std::endl;
+            std::cout << "  Results match: " << (std::abs(result - reference) < 1e-10) << std::endl;
+            if (cold == 0) {
+                std::cerr << "  Warning: no cold lookups, the cold tier was not measured" << std::endl;
+                cold_measured = false;
+            }
+        }
+    }
+
+    return cold_measured ? 0 : 1;
+}
@@ -0,0 +1,506 @@
+#ifndef TIERED_TABLE_HPP
+#define TIERED_TABLE_HPP
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// How cold rows are read from disk
+enum ColdBackend {
+    COLD_IO_URING, // Asynchronous reads through io_uring (raw syscalls, no liburing)
+    COLD_PREAD     // pread() on a pool of I/O threads
+};
+
+const size_t TIERED_PAGE = 4096; // O_DIRECT alignment
+
+// Embedding table split into two tiers. Hot rows (ranked by the caller,
+// e.g. by access frequency) are packed in memory; every other row stays in
+// the binary file (see glove_binary.hpp) and is read into a direct-mapped
+// cache of row slots. prefetch() starts an asynchronous read of a cold row
+// so a later row() finds it ready; row() falls back to a synchronous read.
+//
+// The file is opened with O_DIRECT when the filesystem allows it, so cold
+// reads really go to the device instead of the page cache. Each slot then
+// holds the page-aligned span that covers its row.
+//
+// Not thread safe: prefetch() and row() must be called from one thread.
+class TieredEmbeddingTable {
+public:
+    struct Stats {
+        size_t hotHits = 0;    // Served from the resident hot tier
+        size_t coldHits = 0;   // Cold row already read into its slot
+        size_t coldWaits = 0;  // Cold row still in flight; waited for it
+        size_t coldMisses = 0; // Cold row not prefetched; read synchronously
+        size_t prefetches = 0; // Asynchronous reads issued
+        size_t dropped = 0;    // Prefetches dropped (slot or queue busy)
+    };
+
+    TieredEmbeddingTable(const std::string& binPath, size_t numRows, size_t numCols,
+                         const std::vector<size_t>& hotRows, size_t cacheSlots,
+                         ColdBackend backend, size_t queueDepth = 128, size_t ioThreads = 8)
+        : numCols_(numCols), rowBytes_(numCols * sizeof(double)), cacheSlots_(cacheSlots),
+          backend_(backend), queueDepth_(queueDepth), inflight_(0), toSubmit_(0),
+          ringFd_(-1), ringFailed_(false), stopping_(false) {
+        fd_ = open(binPath.c_str(), O_RDONLY | O_DIRECT);
+        directIO_ = fd_ >= 0;
+        if (!directIO_) {
+            fd_ = open(binPath.c_str(), O_RDONLY);
+        }
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot open " + binPath);
+        }
+
+        // Pack the hot tier
+        hotSlot_.assign(numRows, -1);
+        hot_.resize(hotRows.size() * numCols_);
+        for (size_t h = 0; h < hotRows.size(); h++) {
+            hotSlot_[hotRows[h]] = static_cast<int32_t>(h);
+            readSpan(hotRows[h], reinterpret_cast<char*>(&hot_[h * numCols_]), true);
+        }
+
+        // Cold slots, each large enough for the page-aligned span of a row
+        slotBytes_ = slotBytes(numCols_);
+        void* buffer = nullptr;
+        if (posix_memalign(&buffer, TIERED_PAGE, slotBytes_ * cacheSlots_) != 0) {
+            throw std::bad_alloc();
+        }
+        cache_ = static_cast<char*>(buffer);
+        slotTag_.assign(cacheSlots_, SIZE_MAX);
+        slotState_.reset(new std::atomic<int>[cacheSlots_]);
+        for (size_t s = 0; s < cacheSlots_; s++) {
+            slotState_[s].store(SLOT_EMPTY, std::memory_order_relaxed);
+        }
+
+        if (backend_ == COLD_IO_URING && !setupRing()) {
+            backend_ = COLD_PREAD; // io_uring unavailable; fall back to the thread pool
+        }
+        if (backend_ == COLD_PREAD) {
+            for (size_t t = 0; t < ioThreads; t++) {
+                ioThreads_.push_back(std::thread(&TieredEmbeddingTable::ioWorker, this));
+            }
+        }
+    }
+
+    ~TieredEmbeddingTable() {
+        if (backend_ == COLD_IO_URING) {
+            while (inflight_ > 0) {
+                waitCompletions(1);
+            }
+            munmap(sqRing_, sqRingBytes_);
+            if (cqRing_ != sqRing_) {
+                munmap(cqRing_, cqRingBytes_);
+            }
+            munmap(sqes_, sqesBytes_);
+            close(ringFd_);
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(jobsMutex_);
+                stopping_ = true;
+            }
+            jobsReady_.notify_all();
+            for (auto& thread : ioThreads_) {
+                thread.join();
+            }
+        }
+        free(cache_);
+        close(fd_);
+    }
+
+    // Start reading a cold row into its slot. No-op for hot rows and rows
+    // already cached or in flight; dropped if the slot is busy with another
+    // in-flight row or the I/O queue is full.
+    void prefetch(size_t idx) {
+        if (hotSlot_[idx] >= 0) {
+            return;
+        }
+        size_t slot = idx % cacheSlots_;
+        int state = slotState_[slot].load(std::memory_order_acquire);
+        if (slotTag_[slot] == idx && state != SLOT_EMPTY) {
+            return;
+        }
+        if (state == SLOT_PENDING) {
+            stats_.dropped++;
+            return;
+        }
+        if (backend_ == COLD_IO_URING) {
+            if (!ringFailed_ && inflight_ + toSubmit_ >= queueDepth_) {
+                reapCompletions();
+            }
+            if (ringFailed_ || inflight_ + toSubmit_ >= queueDepth_) {
+                stats_.dropped++;
+                return;
+            }
+        }
+
+        slotTag_[slot] = idx;
+        slotState_[slot].store(SLOT_PENDING, std::memory_order_relaxed);
+        submitRead(slot, idx);
+        stats_.prefetches++;
+    }
+
+    // Pointer to row idx. Valid until the next prefetch() or row() call.
+    const double* row(size_t idx) {
+        int32_t hot = hotSlot_[idx];
+        if (hot >= 0) {
+            stats_.hotHits++;
+            return &hot_[static_cast<size_t>(hot) * numCols_];
+        }
+
+        size_t slot = idx % cacheSlots_;
+        if (slotTag_[slot] == idx) {
+            int state = slotState_[slot].load(std::memory_order_acquire);
+            if (state == SLOT_READY) {
+                stats_.coldHits++;
+                return slotRow(slot, idx);
+            }
+            if (state == SLOT_PENDING) {
+                stats_.coldWaits++;
+                waitSlot(slot);
+                if (slotState_[slot].load(std::memory_order_acquire) == SLOT_READY) {
+                    return slotRow(slot, idx);
+                }
+            }
+        } else if (slotState_[slot].load(std::memory_order_acquire) == SLOT_PENDING) {
+            waitSlot(slot); // Never overwrite a buffer that a read is still filling
+        }
+
+        stats_.coldMisses++;
+        slotTag_[slot] = idx;
+        readSpan(idx, cache_ + slot * slotBytes_, false);
+        slotState_[slot].store(SLOT_READY, std::memory_order_relaxed);
+        return slotRow(slot, idx);
+    }
+
+    // Bytes of one cold slot: the page-aligned span of a row may straddle one extra page
+    static size_t slotBytes(size_t numCols) {
+        return ((numCols * sizeof(double) + TIERED_PAGE - 1) / TIERED_PAGE + 1) * TIERED_PAGE;
+    }
+
+    const Stats& stats() const { return stats_; }
+    ColdBackend backend() const { return backend_; }
+    bool directIO() const { return directIO_; }
+
+    // Bytes held in memory: hot rows, their lookup map and the cold slots
+    size_t residentBytes() const {
+        return hot_.size() * sizeof(double) + hotSlot_.size() * sizeof(int32_t) + cacheSlots_ * slotBytes_;
+    }
+
+private:
+    enum { SLOT_EMPTY, SLOT_PENDING, SLOT_READY };
+
+    // File span covering row idx, page aligned when reading with O_DIRECT
+    void span(size_t idx, off_t& offset, size_t& length, size_t& skip) const {
+        off_t rowOffset = static_cast<off_t>(idx * rowBytes_);
+        if (!directIO_) {
+            offset = rowOffset;
+            length = rowBytes_;
+            skip = 0;
+            return;
+        }
+        offset = rowOffset & ~static_cast<off_t>(TIERED_PAGE - 1);
+        skip = static_cast<size_t>(rowOffset - offset);
+        length = (skip + rowBytes_ + TIERED_PAGE - 1) / TIERED_PAGE * TIERED_PAGE;
+    }
+
+    const double* slotRow(size_t slot, size_t idx) const {
+        off_t offset;
+        size_t length, skip;
+        span(idx, offset, length, skip);
+        return reinterpret_cast<const double*>(cache_ + slot * slotBytes_ + skip);
+    }
+
+    // Synchronous read of row idx. With O_DIRECT the span is read into dest
+    // (which must then be a slot buffer) unless it is staged for the hot tier.
+    // Throws if the read does not cover the whole row.
+    void readSpan(size_t idx, char* dest, bool toHotTier) {
+        off_t offset;
+        size_t length, skip;
+        span(idx, offset, length, skip);
+        if (directIO_ && toHotTier) {
+            std::vector<char> staging(length + TIERED_PAGE);
+            char* aligned = reinterpret_cast<char*>(
+                (reinterpret_cast<uintptr_t>(staging.data()) + TIERED_PAGE - 1) & ~(TIERED_PAGE - 1));
+            checkRead(idx, preadFull(aligned, length, offset));
+            std::memcpy(dest, aligned + skip, rowBytes_);
+        } else if (toHotTier) {
+            checkRead(idx, preadFull(dest, rowBytes_, offset));
+        } else {
+            checkRead(idx, preadFull(dest, length, offset));
+        }
+    }
+
+    void checkRead(size_t idx, size_t done) const {
+        if (!coversRow(idx, done)) {
+            throw std::runtime_error("Short read of row " + std::to_string(idx));
+        }
+    }
+
+    // Returns the bytes read, short of length only at the end of the file
+    // (the last span may run past it) or on an I/O error
+    size_t preadFull(char* dest, size_t length, off_t offset) {
+        size_t done = 0;
+        while (done < length) {
+            ssize_t n = pread(fd_, dest + done, length - done, offset + done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return done;
+    }
+
+    // Whether a read of res bytes into a slot covers the whole row idx
+    bool coversRow(size_t idx, size_t res) const {
+        off_t offset;
+        size_t length, skip;
+        span(idx, offset, length, skip);
+        return res >= skip + rowBytes_;
+    }
+
+    void submitRead(size_t slot, size_t idx) {
+        if (backend_ == COLD_PREAD) {
+            {
+                std::lock_guard<std::mutex> lock(jobsMutex_);
+                jobs_.push_back(std::make_pair(slot, idx));
+            }
+            jobsReady_.notify_one();
+            return;
+        }
+
+        off_t offset;
+        size_t length, skip;
+        span(idx, offset, length, skip);
+        unsigned tail = *sqTail_;
+        unsigned index = tail & *sqMask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(cache_ + slot * slotBytes_);
+        sqe->len = static_cast<uint32_t>(length);
+        sqe->off = static_cast<uint64_t>(offset);
+        sqe->user_data = slot;
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+        // Batch submissions to amortize the syscall; row() flushes when it waits
+        if (++toSubmit_ >= SUBMIT_BATCH) {
+            enter(0);
+        }
+    }
+
+    void waitSlot(size_t slot) {
+        if (backend_ == COLD_PREAD) {
+            while (slotState_[slot].load(std::memory_order_acquire) == SLOT_PENDING) {
+                std::this_thread::yield();
+            }
+            return;
+        }
+        while (slotState_[slot].load(std::memory_order_relaxed) == SLOT_PENDING) {
+            waitCompletions(1);
+        }
+    }
+
+    void ioWorker() {
+        for (;;) {
+            std::pair<size_t, size_t> job;
+            {
+                std::unique_lock<std::mutex> lock(jobsMutex_);
+                jobsReady_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty()) {
+                    return;
+                }
+                job = jobs_.front();
+                jobs_.pop_front();
+            }
+            off_t offset;
+            size_t length, skip;
+            span(job.second, offset, length, skip);
+            size_t done = preadFull(cache_ + job.first * slotBytes_, length, offset);
+            // A short read leaves the slot empty so row() reads it synchronously
+            slotState_[job.first].store(coversRow(job.second, done) ? SLOT_READY : SLOT_EMPTY,
+                                        std::memory_order_release);
+        }
+    }
+
+    bool setupRing() {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queueDepth_), &params));
+        if (ringFd_ < 0) {
+            return false;
+        }
+
+        sqRingBytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap) {
+            sqRingBytes_ = cqRingBytes_ = std::max(sqRingBytes_, cqRingBytes_);
+        }
+        sqRing_ = mmap(nullptr, sqRingBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd_, IORING_OFF_SQ_RING);
+        cqRing_ = singleMmap ? sqRing_
+                             : mmap(nullptr, cqRingBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    ringFd_, IORING_OFF_CQ_RING);
+        sqesBytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqesBytes_, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+        if (sqRing_ == MAP_FAILED || cqRing_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            // Unmap whichever mappings did succeed before falling back
+            if (sqRing_ != MAP_FAILED) {
+                munmap(sqRing_, sqRingBytes_);
+            }
+            if (!singleMmap && cqRing_ != MAP_FAILED) {
+                munmap(cqRing_, cqRingBytes_);
+            }
+            if (sqes_ != MAP_FAILED) {
+                munmap(sqes_, sqesBytes_);
+            }
+            close(ringFd_);
+            ringFd_ = -1;
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqRing_);
+        char* cq = static_cast<char*>(cqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Submit queued reads and optionally block for minComplete completions.
+    // Interrupted calls are retried, calls refused for lack of resources are
+    // retried up to ENTER_RETRIES times after reaping; any other error gives
+    // up on the ring (see abandonRing).
+    void enter(unsigned minComplete) {
+        unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        for (size_t retries = 0;;) {
+            long ret = syscall(__NR_io_uring_enter, ringFd_, static_cast<unsigned>(toSubmit_), minComplete,
+                               flags, nullptr, 0);
+            if (ret >= 0) {
+                inflight_ += static_cast<size_t>(ret);
+                toSubmit_ -= static_cast<size_t>(ret);
+                return;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EAGAIN || errno == EBUSY) && ++retries < ENTER_RETRIES) {
+                reapCompletions();
+                std::this_thread::yield();
+                continue;
+            }
+            abandonRing();
+            return;
+        }
+    }
+
+    // Stop using the ring after io_uring_enter failed: reads not yet
+    // submitted are dropped and their slots left empty, so row() reads them
+    // synchronously, and prefetch() issues no new ones. Reads already
+    // submitted still complete and are reaped by polling the ring.
+    void abandonRing() {
+        ringFailed_ = true;
+        unsigned tail = *sqTail_;
+        for (size_t k = 1; k <= toSubmit_; k++) {
+            size_t slot = static_cast<size_t>(sqes_[(tail - k) & *sqMask_].user_data);
+            slotState_[slot].store(SLOT_EMPTY, std::memory_order_relaxed);
+        }
+        __atomic_store_n(sqTail_, tail - static_cast<unsigned>(toSubmit_), __ATOMIC_RELEASE);
+        toSubmit_ = 0;
+    }
+
+    void waitCompletions(unsigned minComplete) {
+        if (ringFailed_) {
+            std::this_thread::yield();
+        } else if (inflight_ + toSubmit_ > 0) {
+            enter(minComplete);
+        }
+        reapCompletions();
+    }
+
+    void reapCompletions() {
+        unsigned head = *cqHead_;
+        unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+            size_t slot = static_cast<size_t>(cqe.user_data);
+            // A failed or short read leaves the slot empty so row() reads it synchronously
+            bool ready = cqe.res > 0 && coversRow(slotTag_[slot], static_cast<size_t>(cqe.res));
+            slotState_[slot].store(ready ? SLOT_READY : SLOT_EMPTY, std::memory_order_relaxed);
+            inflight_--;
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+    static const size_t SUBMIT_BATCH = 8;
+    static const size_t ENTER_RETRIES = 1000;
+
+    int fd_;
+    bool directIO_;
+    size_t numCols_;
+    size_t rowBytes_;
+    size_t slotBytes_;
+    size_t cacheSlots_;
+    ColdBackend backend_;
+    size_t queueDepth_;
+
+    std::vector<int32_t> hotSlot_; // Position of each row in hot_, or -1 if cold
+    std::vector<double> hot_;
+    char* cache_;
+    std::vector<size_t> slotTag_;  // Row held or being read by each slot
+    std::unique_ptr<std::atomic<int>[]> slotState_;
+    Stats stats_;
+
+    // io_uring backend
+    size_t inflight_;
+    size_t toSubmit_;
+    int ringFd_;
+    bool ringFailed_; // io_uring_enter failed; only in-flight reads are still reaped
+    void* sqRing_;
+    void* cqRing_;
+    size_t sqRingBytes_;
+    size_t cqRingBytes_;
+    io_uring_sqe* sqes_;
+    size_t sqesBytes_;
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqArray_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    io_uring_cqe* cqes_;
+
+    // pread backend
+    std::vector<std::thread> ioThreads_;
+    std::deque<std::pair<size_t, size_t>> jobs_;
+    std::mutex jobsMutex_;
+    std::condition_variable jobsReady_;
+    bool stopping_;
+};
+
+#endif // TIERED_TABLE_HPP
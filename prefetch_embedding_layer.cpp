@@ -9,6 +9,7 @@
 #include <string>
 #include <numeric> // For std::accumulate
 #include <cmath> // For std::sqrt
+#include "embedding_layers/prefetch_pipeline.hpp" // Policy-based lookup kernels
 
 // Global constants
 const std::string GLOVE_PATH = "data/glove.twitter.27B.25d.txt";
@@ -16,49 +17,11 @@ const std::string INPUT_PATH = "data/input.txt";
 const size_t NUM_COLS = 25;        // GloVe embedding dimension
 const size_t PREFETCH_AHEAD = 11;   // Fixed prefetch ahead distance
 
-// Function to perform row operations with prefetching
+// Function to perform row operations with prefetching, PREFETCH_AHEAD rows ahead
 double prefetchedAccess(const std::vector<std::vector<double>>& matrix, 
-                       const std::vector<size_t>& accessPattern,
-                       size_t prefetch_ahead) {
-    double result = 0.0;
-    
-    // Handle first chunk with prefetching
-    size_t i = 0;
-    for (; i < accessPattern.size() - prefetch_ahead; i++) {
-        const char* next_row = reinterpret_cast<const char*>(&matrix[accessPattern[i + prefetch_ahead]][0]);
-        _mm_prefetch(next_row, _MM_HINT_T0);
-        //_MM_HINT_T0: Prefetch into all levels of the cache.
-        //_MM_HINT_T1: Prefetch into L2 cache only.
-        //_MM_HINT_T2: Prefetch into L1 cache only.
-        //_MM_HINT_NTA: Do not prefetch.
-        
-        const auto& row = matrix[accessPattern[i]];
-        double row_sum = 0.0;
-        for (size_t n = 0; n < 2; n++) {
-            double dot_product = 0.0;
-            for (size_t j = 0; j < NUM_COLS; j++) {
-                dot_product += row[j] * row[j];
-            }
-            row_sum += dot_product;
-        }
-        result += row_sum / NUM_COLS;
-    }
-    
-    // Handle remaining elements without prefetching
-    for (; i < accessPattern.size(); i++) {
-        const auto& row = matrix[accessPattern[i]];
-        double row_sum = 0.0;
-        for (size_t n = 0; n < 2; n++) {
-            double dot_product = 0.0;
-            for (size_t j = 0; j < NUM_COLS; j++) {
-                dot_product += row[j] * row[j];
-            }
-            row_sum += dot_product;
-        }
-        result += row_sum / NUM_COLS;
-    }
-    
-    return result / accessPattern.size();
+                       const std::vector<size_t>& accessPattern) {
+    return pipelineAccess<double, NUM_COLS, DoubleDotReduce, FirstLinePrefetch<_MM_HINT_T0> >(
+        matrix, accessPattern, FixedDistancePredictor<PREFETCH_AHEAD>());
 }
 
 int main() {
@@ -106,7 +69,7 @@ int main() {
     // Perform prefetched access
     std::cout << "Performing prefetched access with PREFETCH_AHEAD = " << PREFETCH_AHEAD << "..." << std::endl;
     auto start = std::chrono::steady_clock::now();
-    double result = prefetchedAccess(matrix, accessPattern, PREFETCH_AHEAD);
+    double result = prefetchedAccess(matrix, accessPattern);
     auto end = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
     std::cout << "Prefetched access result: " << result << std::endl;
@@ -14,13 +14,14 @@ CPP_FILES="$1"
 EXECUTABLE_NAME="${CPP_FILES%.*}"  # Remove .cpp extension
 EXECUTABLE_DIR="executables"
 EXECUTABLE="$EXECUTABLE_DIR/$EXECUTABLE_NAME"
+CXX_STD="${CXX_STD:-c++11}"  # e.g. CXX_STD=c++20 for coroutine_prefetching.cpp
 
 # Create executables directory if it doesn't exist
 mkdir -p "$EXECUTABLE_DIR"
 
 # Compile with aggressive optimizations
 echo "Compiling $CPP_FILES with aggressive optimizations..."
-g++ -std=c++11 -O3 -march=native -ffast-math -funroll-loops -fomit-frame-pointer \
+g++ -std="$CXX_STD" -O3 -march=native -ffast-math -funroll-loops -fomit-frame-pointer \
     -flto -fno-signed-zeros -fno-trapping-math -pthread \
     -o "$EXECUTABLE" "$CPP_FILES"
 